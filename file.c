@@ -0,0 +1,391 @@
+#include "file.h"
+
+#include "math.h"
+
+#include <stdio.h>
+
+#include <string.h>
+
+#ifdef _WIN32
+
+#include "platform.h"
+
+#else
+
+#include <fcntl.h>
+
+#include <sys/mman.h>
+
+#include <sys/stat.h>
+
+#include <unistd.h>
+
+#endif
+
+typedef struct File_Pack_Item File_Pack_Item;
+
+struct File_Pack_Item
+{
+	unsigned int hash;
+
+	const char* name;
+
+	File_Mapping* mapping;
+};
+
+static unsigned int file_pack_hash(const char* name)
+{
+	unsigned int hash = 2166136261u;
+
+	for (const unsigned char* c = (const unsigned char*)name; *c != 0; c++)
+	{
+		hash = (hash ^ *c) * 16777619u;
+	}
+
+	return hash;
+}
+
+static int file_pack_get_bucket(unsigned int hash, int bucket_count)
+{
+	return (int)(((unsigned long long)hash * bucket_count) >> 32);
+}
+
+static size_t file_pack_get_entries_offset(int bucket_count)
+{
+	return (sizeof(File_Pack_Header) + (bucket_count + 1) * sizeof(int) + sizeof(long long) - 1) / sizeof(long long) * sizeof(long long);
+}
+
+static size_t file_pack_align(size_t offset)
+{
+	return (offset + FILE_PACK_ALIGNMENT - 1) / FILE_PACK_ALIGNMENT * FILE_PACK_ALIGNMENT;
+}
+
+static int file_pack_item_compare(const void* item_1, const void* item_2)
+{
+	const File_Pack_Item* i_1 = item_1;
+
+	const File_Pack_Item* i_2 = item_2;
+
+	if (i_1->hash != i_2->hash)
+	{
+		return (i_1->hash > i_2->hash) - (i_1->hash < i_2->hash);
+	}
+
+	return strcmp(i_1->name, i_2->name);
+}
+
+File_Mapping* file_mapping_create(const char* path)
+{
+#ifdef _WIN32
+
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+
+		return NULL;
+	}
+
+	const void* data = NULL;
+
+	size_t data_size = size.QuadPart;
+
+	if (data_size > 0)
+	{
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+		data = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+		if (mapping != NULL)
+		{
+			CloseHandle(mapping);
+		}
+
+		if (data == NULL)
+		{
+			CloseHandle(file);
+
+			return NULL;
+		}
+	}
+
+	CloseHandle(file);
+
+#else
+
+	int file = open(path, O_RDONLY);
+
+	if (file < 0)
+	{
+		return NULL;
+	}
+
+	struct stat status;
+
+	if (fstat(file, &status) != 0)
+	{
+		close(file);
+
+		return NULL;
+	}
+
+	const void* data = NULL;
+
+	size_t data_size = status.st_size;
+
+	if (data_size > 0)
+	{
+		data = mmap(NULL, data_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		if (data == MAP_FAILED)
+		{
+			close(file);
+
+			return NULL;
+		}
+	}
+
+	close(file);
+
+#endif
+
+	File_Mapping* mapping = malloc(sizeof(File_Mapping));
+
+	mapping->data = data;
+
+	mapping->size = data_size;
+
+	return mapping;
+}
+
+void file_mapping_destroy(File_Mapping* mapping)
+{
+	if (mapping->data != NULL)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mapping->data);
+#else
+		munmap((void*)mapping->data, mapping->size);
+#endif
+	}
+
+	free(mapping);
+}
+
+void file_mapping_prefetch(const File_Mapping* mapping)
+{
+	volatile unsigned char sum = 0;
+
+	for (size_t i = 0; i < mapping->size; i += FILE_PAGE_SIZE)
+	{
+		sum += mapping->data[i];
+	}
+}
+
+File_Pack* file_pack_create(const char* path)
+{
+	File_Mapping* mapping = file_mapping_create(path);
+
+	if (mapping == NULL)
+	{
+		return NULL;
+	}
+
+	const File_Pack_Header* header = (const File_Pack_Header*)mapping->data;
+
+	bool valid = mapping->size >= sizeof(File_Pack_Header) && header->magic == FILE_PACK_MAGIC && header->entry_count >= 0 && header->bucket_count > 0 && header->name_size > 0;
+
+	size_t entries_offset = valid ? file_pack_get_entries_offset(header->bucket_count) : 0;
+
+	size_t names_offset = valid ? entries_offset + header->entry_count * sizeof(File_Pack_Entry) : 0;
+
+	valid = valid && names_offset + header->name_size <= mapping->size;
+
+	File_Pack* pack = malloc(sizeof(File_Pack));
+
+	pack->mapping = mapping;
+
+	pack->header = header;
+
+	pack->bucket_starts = (const int*)(mapping->data + sizeof(File_Pack_Header));
+
+	pack->entries = (const File_Pack_Entry*)(mapping->data + entries_offset);
+
+	pack->names = (const char*)(mapping->data + names_offset);
+
+	valid = valid && pack->bucket_starts[0] == 0 && pack->bucket_starts[header->bucket_count] == header->entry_count && pack->names[header->name_size - 1] == 0;
+
+	for (int i = 0; valid && i < header->bucket_count; i++)
+	{
+		valid = pack->bucket_starts[i] <= pack->bucket_starts[i + 1];
+	}
+
+	for (int i = 0; valid && i < header->entry_count; i++)
+	{
+		const File_Pack_Entry* entry = &pack->entries[i];
+
+		valid = entry->name_offset >= 0 && entry->name_offset < header->name_size && entry->offset >= 0 && entry->size >= 0 && entry->offset + entry->size <= (long long)mapping->size;
+	}
+
+	if (!valid)
+	{
+		file_pack_destroy(pack);
+
+		return NULL;
+	}
+
+	return pack;
+}
+
+void file_pack_destroy(File_Pack* pack)
+{
+	file_mapping_destroy(pack->mapping);
+
+	free(pack);
+}
+
+const unsigned char* file_pack_find(const File_Pack* pack, const char* name, size_t* size)
+{
+	unsigned int hash = file_pack_hash(name);
+
+	int bucket = file_pack_get_bucket(hash, pack->header->bucket_count);
+
+	for (int i = pack->bucket_starts[bucket]; i < pack->bucket_starts[bucket + 1]; i++)
+	{
+		const File_Pack_Entry* entry = &pack->entries[i];
+
+		if (entry->hash == hash && strcmp(pack->names + entry->name_offset, name) == 0)
+		{
+			*size = entry->size;
+
+			return pack->mapping->data + entry->offset;
+		}
+	}
+
+	return NULL;
+}
+
+bool file_pack_build(const char* path, int file_count, const char* const names[], const char* const file_paths[])
+{
+	File_Pack_Item* items = malloc((file_count + 1) * sizeof(File_Pack_Item));
+
+	bool valid = true;
+
+	int name_size = 1;
+
+	for (int i = 0; i < file_count; i++)
+	{
+		items[i].hash = file_pack_hash(names[i]);
+
+		items[i].name = names[i];
+
+		items[i].mapping = valid ? file_mapping_create(file_paths[i]) : NULL;
+
+		valid = items[i].mapping != NULL;
+
+		name_size += strlen(names[i]) + 1;
+	}
+
+	qsort(items, file_count, sizeof(File_Pack_Item), file_pack_item_compare);
+
+	for (int i = 1; valid && i < file_count; i++)
+	{
+		valid = items[i].hash != items[i - 1].hash || strcmp(items[i].name, items[i - 1].name) != 0;
+	}
+
+	FILE* file = valid ? fopen(path, "wb") : NULL;
+
+	if (file != NULL)
+	{
+		File_Pack_Header header = { FILE_PACK_MAGIC, file_count, imax(file_count, 1), name_size };
+
+		int* bucket_starts = calloc(header.bucket_count + 1, sizeof(int));
+
+		File_Pack_Entry* entries = malloc(imax(file_count, 1) * sizeof(File_Pack_Entry));
+
+		char* name_data = calloc(name_size, 1);
+
+		size_t entries_offset = file_pack_get_entries_offset(header.bucket_count);
+
+		size_t offset = file_pack_align(entries_offset + file_count * sizeof(File_Pack_Entry) + name_size);
+
+		int name_offset = 1;
+
+		for (int i = 0; i < file_count; i++)
+		{
+			bucket_starts[file_pack_get_bucket(items[i].hash, header.bucket_count) + 1]++;
+
+			entries[i].hash = items[i].hash;
+
+			entries[i].name_offset = name_offset;
+
+			entries[i].offset = offset;
+
+			entries[i].size = items[i].mapping->size;
+
+			strcpy(name_data + name_offset, items[i].name);
+
+			name_offset += strlen(items[i].name) + 1;
+
+			offset = file_pack_align(offset + items[i].mapping->size);
+		}
+
+		for (int i = 0; i < header.bucket_count; i++)
+		{
+			bucket_starts[i + 1] += bucket_starts[i];
+		}
+
+		static const unsigned char padding[FILE_PACK_ALIGNMENT + sizeof(long long)];
+
+		size_t position = sizeof(header) + (header.bucket_count + 1) * sizeof(int);
+
+		valid = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(bucket_starts, sizeof(int), header.bucket_count + 1, file) == header.bucket_count + 1;
+
+		valid = valid && fwrite(padding, 1, entries_offset - position, file) == entries_offset - position;
+
+		valid = valid && fwrite(entries, sizeof(File_Pack_Entry), file_count, file) == file_count && fwrite(name_data, 1, name_size, file) == name_size;
+
+		position = entries_offset + file_count * sizeof(File_Pack_Entry) + name_size;
+
+		for (int i = 0; i < file_count; i++)
+		{
+			valid = valid && fwrite(padding, 1, entries[i].offset - position, file) == entries[i].offset - position;
+
+			valid = valid && fwrite(items[i].mapping->data, 1, items[i].mapping->size, file) == items[i].mapping->size;
+
+			position = entries[i].offset + items[i].mapping->size;
+		}
+
+		free(name_data);
+
+		free(entries);
+
+		free(bucket_starts);
+
+		valid = fclose(file) == 0 && valid;
+	}
+	else
+	{
+		valid = false;
+	}
+
+	for (int i = 0; i < file_count; i++)
+	{
+		if (items[i].mapping != NULL)
+		{
+			file_mapping_destroy(items[i].mapping);
+		}
+	}
+
+	free(items);
+
+	return valid;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include <stdlib.h>
+
+#define FILE_PAGE_SIZE 4096
+
+#define FILE_PACK_MAGIC 0x4B434150
+
+#define FILE_PACK_ALIGNMENT 64
+
+typedef struct File_Mapping File_Mapping;
+
+typedef struct File_Pack File_Pack;
+
+typedef struct File_Pack_Header File_Pack_Header;
+
+typedef struct File_Pack_Entry File_Pack_Entry;
+
+struct File_Mapping
+{
+	const unsigned char* data;
+
+	size_t size;
+};
+
+struct File_Pack
+{
+	File_Mapping* mapping;
+
+	const File_Pack_Header* header;
+
+	const int* bucket_starts;
+
+	const File_Pack_Entry* entries;
+
+	const char* names;
+};
+
+struct File_Pack_Header
+{
+	int magic;
+
+	int entry_count;
+
+	int bucket_count;
+
+	int name_size;
+};
+
+struct File_Pack_Entry
+{
+	unsigned int hash;
+
+	int name_offset;
+
+	long long offset;
+
+	long long size;
+};
+
+File_Mapping* file_mapping_create(const char* path);
+
+void file_mapping_destroy(File_Mapping* mapping);
+
+void file_mapping_prefetch(const File_Mapping* mapping);
+
+File_Pack* file_pack_create(const char* path);
+
+void file_pack_destroy(File_Pack* pack);
+
+const unsigned char* file_pack_find(const File_Pack* pack, const char* name, size_t* size);
+
+bool file_pack_build(const char* path, int file_count, const char* const names[], const char* const file_paths[]);
@@ -1,592 +1,2373 @@
 #include "geometry.h"
 
-Vector vector_create(double x, double y)
-{
-	Vector v = { x, y };
+#ifdef __SSE2__
 
-	return v;
-}
+#include <emmintrin.h>
 
-bool vector_equal(Vector v, Vector w)
-{
-	return v.x == w.x && v.y == w.y;
-}
+#endif
 
-Vector vector_negate(Vector v)
-{
-	return vector_create(-v.x, -v.y);
-}
+typedef struct Distance_Vertex Distance_Vertex;
 
-Vector vector_add(Vector v, Vector w)
+struct Distance_Vertex
 {
-	return vector_create(v.x + w.x, v.y + w.y);
-}
+	Vector point_1;
 
-Vector vector_add_value(Vector v, double w)
-{
-	return vector_create(v.x + w, v.y + w);
-}
+	Vector point_2;
 
-Vector vector_add_xy(Vector v, double x, double y)
-{
-	return vector_create(v.x + x, v.y + y);
-}
+	Vector point;
 
-Vector vector_subtract(Vector v, Vector w)
-{
-	return vector_create(v.x - w.x, v.y - w.y);
-}
+	double weight;
 
-Vector vector_subtract_value(Vector v, double w)
-{
-	return vector_create(v.x - w, v.y - w);
-}
+	int index_1;
 
-Vector vector_subtract_xy(Vector v, double x, double y)
-{
-	return vector_create(v.x - x, v.y - y);
-}
+	int index_2;
+};
 
-Vector vector_multiply(Vector v, double s)
-{
-	return vector_create(v.x * s, v.y * s);
-}
+#ifdef __SSE2__
 
-Vector vector_divide(Vector v, double s)
+static __m128d raycast_select(__m128d mask, __m128d a, __m128d b)
 {
-	return vector_create(v.x / s, v.y / s);
+	return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
 }
 
-Vector vector_scale(Vector v, Vector s)
-{
-	return vector_create(v.x * s.x, v.y * s.y);
-}
+#endif
 
-Vector vector_downscale(Vector v, Vector s)
+static void get_distance_points(const Shape* shape, const Vector** points, int* point_count, double* radius)
 {
-	return vector_create(v.x / s.x, v.y / s.y);
-}
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			*points = &shape->segment.a;
 
-Vector vector_rotate(Vector v, double a)
-{
-	double s = sin(a);
+			*point_count = 2;
 
-	double c = cos(a);
+			*radius = 0.0;
 
-	return vector_create(c * v.x - s * v.y, s * v.x + c * v.y);
-}
+			break;
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			*points = &shape->circle.center;
 
-Vector vector_left(Vector v)
-{
-	return vector_create(-v.y, v.x);
-}
+			*point_count = 1;
 
-Vector vector_right(Vector v)
-{
-	return vector_create(v.y, -v.x);
-}
+			*radius = shape->circle.radius;
 
-Vector vector_normalize(Vector v)
-{
-	return vector_divide(v, vector_length(v));
-}
+			break;
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			*points = shape->polygon.points;
 
-double vector_length(Vector v)
-{
-	return sqrt(vector_length_squared(v));
-}
+			*point_count = shape->polygon.point_count;
 
-double vector_length_squared(Vector v)
-{
-	return square(v.x) + square(v.y);
-}
+			*radius = 0.0;
 
-double vector_distance(Vector v, Vector w)
-{
-	return sqrt(vector_distance_squared(v, w));
+			break;
+		}
+	}
 }
 
-double vector_distance_squared(Vector v, Vector w)
+static int get_support_index(const Vector points[], int point_count, Vector direction)
 {
-	return square(v.x - w.x) + square(v.y - w.y);
-}
+	int best_index = 0;
 
-double vector_dot(Vector v, Vector w)
-{
-	return v.x * w.x + v.y * w.y;
-}
+	double best_value = vector_dot(points[0], direction);
 
-double vector_cross(Vector v, Vector w)
-{
-	return v.x * w.y - v.y * w.x;
-}
+	for (int i = 1; i < point_count; i++)
+	{
+		double value = vector_dot(points[i], direction);
 
-Vector vector_middle(Vector v, Vector w)
-{
-	return vector_multiply(vector_add(v, w), 0.5);
+		if (value > best_value)
+		{
+			best_index = i;
+
+			best_value = value;
+		}
+	}
+
+	return best_index;
 }
 
-Transform transform_create(Vector translation, double rotation)
+static void set_distance_vertex(Distance_Vertex* vertex, const Vector points_1[], int index_1, const Vector points_2[], int index_2)
 {
-	Transform transform;
+	vertex->index_1 = index_1;
 
-	transform.x = translation.x;
+	vertex->index_2 = index_2;
 
-	transform.y = translation.y;
+	vertex->point_1 = points_1[index_1];
 
-	transform.s = sin(rotation);
+	vertex->point_2 = points_2[index_2];
 
-	transform.c = cos(rotation);
+	vertex->point = vector_subtract(vertex->point_2, vertex->point_1);
 
-	return transform;
+	vertex->weight = 1.0;
 }
 
-Transform transform_invert(Transform transform)
+static int solve_distance_simplex_2(Distance_Vertex vertices[])
 {
-	Transform result;
-
-	result.x = -transform.c * transform.x - transform.s * transform.y;
+	Vector side = vector_subtract(vertices[1].point, vertices[0].point);
 
-	result.y =  transform.s * transform.x - transform.c * transform.y;
+	double weight_2 = -vector_dot(vertices[0].point, side);
 
-	result.s = -transform.s;
+	if (weight_2 <= 0.0)
+	{
+		vertices[0].weight = 1.0;
 
-	result.c =  transform.c;
+		return 1;
+	}
 
-	return result;
-}
+	double weight_1 = vector_dot(vertices[1].point, side);
 
-Vector transform_apply(Transform transform, Vector vector)
-{
-	Vector result;
+	if (weight_1 <= 0.0)
+	{
+		vertices[0] = vertices[1];
 
-	result.x = transform.c * vector.x - transform.s * vector.y + transform.x;
+		vertices[0].weight = 1.0;
 
-	result.y = transform.s * vector.x + transform.c * vector.y + transform.y;
+		return 1;
+	}
 
-	return result;
-}
+	vertices[0].weight = weight_1 / (weight_1 + weight_2);
 
-Vector segment_get_centroid(const Segment* segment)
-{
-	return vector_middle(segment->a, segment->b);
-}
+	vertices[1].weight = weight_2 / (weight_1 + weight_2);
 
-double segment_get_linear_mass_factor(const Segment* segment)
-{
-	return vector_distance(segment->a, segment->b);
+	return 2;
 }
 
-double segment_get_angular_mass_factor(const Segment* segment)
+static int solve_distance_simplex_3(Distance_Vertex vertices[])
 {
-	return vector_distance_squared(segment->a, segment->b) / 12.0;
-}
+	Vector w_1 = vertices[0].point;
 
-Rect segment_get_bounding_rect(const Segment* segment)
-{
-	Rect rect;
+	Vector w_2 = vertices[1].point;
 
-	rect.min = vector_create(fmin(segment->a.x, segment->b.x), fmin(segment->a.y, segment->b.y));
+	Vector w_3 = vertices[2].point;
 
-	rect.max = vector_create(fmax(segment->a.x, segment->b.x), fmax(segment->a.y, segment->b.y));
+	Vector side_12 = vector_subtract(w_2, w_1);
 
-	return rect;
-}
+	Vector side_13 = vector_subtract(w_3, w_1);
 
-void segment_transform(const Segment* segment, Transform transform, Segment* result)
-{
-	result->a = transform_apply(transform, segment->a);
+	Vector side_23 = vector_subtract(w_3, w_2);
 
-	result->b = transform_apply(transform, segment->b);
-}
+	double weight_12_1 = vector_dot(w_2, side_12);
 
-bool segment_test_point(const Segment* segment, Vector point)
-{
-	Vector ab = vector_subtract(segment->b, segment->a);
+	double weight_12_2 = -vector_dot(w_1, side_12);
 
-	return vector_dot(ab, point) >= vector_dot(ab, segment->a) && vector_dot(ab, point) <= vector_dot(ab, segment->b) && vector_cross(ab, point) == vector_cross(ab, segment->a);
-}
+	double weight_13_1 = vector_dot(w_3, side_13);
 
-Vector circle_get_centroid(const Circle* circle)
-{
-	return circle->center;
-}
+	double weight_13_2 = -vector_dot(w_1, side_13);
 
-double circle_get_linear_mass_factor(const Circle* circle)
-{
-	return square(circle->radius) * M_PI;
-}
+	double weight_23_1 = vector_dot(w_3, side_23);
 
-double circle_get_angular_mass_factor(const Circle* circle)
-{
-	return square(circle->radius) / 2.0;
-}
+	double weight_23_2 = -vector_dot(w_2, side_23);
 
-Rect circle_get_bounding_rect(const Circle* circle)
-{
-	Rect rect;
+	double area = vector_cross(side_12, side_13);
 
-	rect.min = vector_subtract_value(circle->center, circle->radius);
+	double weight_123_1 = area * vector_cross(w_2, w_3);
 
-	rect.max = vector_add_value(circle->center, circle->radius);
+	double weight_123_2 = area * vector_cross(w_3, w_1);
 
-	return rect;
-}
+	double weight_123_3 = area * vector_cross(w_1, w_2);
 
-void circle_transform(const Circle* circle, Transform transform, Circle* result)
-{
-	result->center = transform_apply(transform, circle->center);
+	if (weight_12_2 <= 0.0 && weight_13_2 <= 0.0)
+	{
+		vertices[0].weight = 1.0;
 
-	result->radius = circle->radius;
-}
+		return 1;
+	}
 
-bool circle_test_point(const Circle* circle, Vector point)
-{
-	return vector_distance_squared(circle->center, point) <= square(circle->radius);
-}
+	if (weight_12_1 > 0.0 && weight_12_2 > 0.0 && weight_123_3 <= 0.0)
+	{
+		vertices[0].weight = weight_12_1 / (weight_12_1 + weight_12_2);
 
-Vector polygon_get_centroid(const Polygon* polygon)
-{
-	Vector centroid = { 0.0, 0.0 };
+		vertices[1].weight = weight_12_2 / (weight_12_1 + weight_12_2);
 
-	double weight = 0.0;
+		return 2;
+	}
 
-	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+	if (weight_13_1 > 0.0 && weight_13_2 > 0.0 && weight_123_2 <= 0.0)
 	{
-		Vector a = polygon->points[i];
-
-		Vector b = polygon->points[j];
+		vertices[0].weight = weight_13_1 / (weight_13_1 + weight_13_2);
 
-		double side_length = vector_distance(a, b);
+		vertices[1] = vertices[2];
 
-		centroid = vector_add(centroid, vector_multiply(vector_middle(a, b), side_length));
+		vertices[1].weight = weight_13_2 / (weight_13_1 + weight_13_2);
 
-		weight += side_length;
+		return 2;
 	}
 
-	return vector_divide(centroid, weight);
-}
+	if (weight_12_1 <= 0.0 && weight_23_2 <= 0.0)
+	{
+		vertices[0] = vertices[1];
 
-double polygon_get_linear_mass_factor(const Polygon* polygon)
-{
-	double area = 0.0;
+		vertices[0].weight = 1.0;
 
-	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+		return 1;
+	}
+
+	if (weight_13_1 <= 0.0 && weight_23_1 <= 0.0)
 	{
-		Vector a = polygon->points[i];
+		vertices[0] = vertices[2];
 
-		Vector b = polygon->points[j];
+		vertices[0].weight = 1.0;
 
-		area += vector_cross(a, b);
+		return 1;
 	}
 
-	area /= 2.0;
+	if (weight_23_1 > 0.0 && weight_23_2 > 0.0 && weight_123_1 <= 0.0)
+	{
+		vertices[0] = vertices[2];
 
-	return area;
-}
+		vertices[0].weight = weight_23_2 / (weight_23_1 + weight_23_2);
 
-double polygon_get_angular_mass_factor(const Polygon* polygon)
-{
-	double numerator = 0.0;
+		vertices[1].weight = weight_23_1 / (weight_23_1 + weight_23_2);
 
-	double denominator = 0.0;
+		return 2;
+	}
 
-	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
-	{
-		Vector a = polygon->points[i];
+	double weight_123 = weight_123_1 + weight_123_2 + weight_123_3;
 
-		Vector b = polygon->points[j];
+	vertices[0].weight = weight_123_1 / weight_123;
 
-		numerator += vector_cross(a, b) * (vector_dot(a, a) + vector_dot(a, b) + vector_dot(b, b));
+	vertices[1].weight = weight_123_2 / weight_123;
 
-		denominator += vector_cross(a, b) * 6.0;
-	}
+	vertices[2].weight = weight_123_3 / weight_123;
 
-	return numerator / denominator - vector_length_squared(polygon_get_centroid(polygon));
+	return 3;
 }
 
-Rect polygon_get_bounding_rect(const Polygon* polygon)
+static double compute_distance(const Shape* shape_1, const Shape* shape_2, Distance_Cache* cache, double lower_limit, double upper_limit, Vector* closest_1, Vector* closest_2)
 {
-	Rect rect;
+	const Vector* points_1;
 
-	rect.min.x = INFINITY;
+	const Vector* points_2;
 
-	rect.min.y = INFINITY;
+	int point_count_1;
 
-	rect.max.x = -INFINITY;
+	int point_count_2;
 
-	rect.max.y = -INFINITY;
+	double radius_1;
 
-	for (int i = 0; i < polygon->point_count; i++)
-	{
-		rect.min.x = fmin(rect.min.x, polygon->points[i].x);
+	double radius_2;
 
-		rect.min.y = fmin(rect.min.y, polygon->points[i].y);
+	get_distance_points(shape_1, &points_1, &point_count_1, &radius_1);
 
-		rect.max.x = fmax(rect.max.x, polygon->points[i].x);
+	get_distance_points(shape_2, &points_2, &point_count_2, &radius_2);
 
-		rect.max.y = fmax(rect.max.y, polygon->points[i].y);
-	}
+	double radius = radius_1 + radius_2;
 
-	return rect;
-}
+	Distance_Vertex vertices[3];
 
-void polygon_transform(const Polygon* polygon, Transform transform, Polygon* result)
-{
-	for (int i = 0; i < polygon->point_count; i++)
+	int vertex_count = 0;
+
+	if (cache != NULL)
 	{
-		result->points[i] = transform_apply(transform, polygon->points[i]);
+		for (int i = 0; i < cache->count && i < 3; i++)
+		{
+			if (cache->indices_1[i] < 0 || cache->indices_1[i] >= point_count_1 || cache->indices_2[i] < 0 || cache->indices_2[i] >= point_count_2)
+			{
+				vertex_count = 0;
+
+				break;
+			}
+
+			set_distance_vertex(&vertices[vertex_count++], points_1, cache->indices_1[i], points_2, cache->indices_2[i]);
+		}
+	}
+
+	if (vertex_count == 0)
+	{
+		set_distance_vertex(&vertices[vertex_count++], points_1, 0, points_2, 0);
+	}
+
+	double lower_bound = -INFINITY;
+
+	for (int iteration = 0; iteration < DISTANCE_ITERATION_COUNT_MAX; iteration++)
+	{
+		int saved_count = vertex_count;
+
+		int saved_indices_1[3];
+
+		int saved_indices_2[3];
+
+		for (int i = 0; i < vertex_count; i++)
+		{
+			saved_indices_1[i] = vertices[i].index_1;
+
+			saved_indices_2[i] = vertices[i].index_2;
+		}
+
+		if (vertex_count == 2)
+		{
+			vertex_count = solve_distance_simplex_2(vertices);
+		}
+		else if (vertex_count == 3)
+		{
+			vertex_count = solve_distance_simplex_3(vertices);
+		}
+
+		if (vertex_count == 3)
+		{
+			break;
+		}
+
+		Vector direction;
+
+		if (vertex_count == 1)
+		{
+			direction = vector_negate(vertices[0].point);
+		}
+		else
+		{
+			Vector side = vector_subtract(vertices[1].point, vertices[0].point);
+
+			direction = vector_cross(side, vector_negate(vertices[0].point)) > 0.0 ? vector_left(side) : vector_right(side);
+		}
+
+		if (vector_length_squared(direction) < square(DISTANCE_EPSILON))
+		{
+			break;
+		}
+
+		Vector closest = vertex_count == 1 ? vertices[0].point : vector_add(vector_multiply(vertices[0].point, vertices[0].weight), vector_multiply(vertices[1].point, vertices[1].weight));
+
+		if (vector_length(closest) - radius <= lower_limit)
+		{
+			break;
+		}
+
+		Distance_Vertex* vertex = &vertices[vertex_count];
+
+		set_distance_vertex(vertex, points_1, get_support_index(points_1, point_count_1, vector_negate(direction)), points_2, get_support_index(points_2, point_count_2, direction));
+
+		lower_bound = fmax(lower_bound, -vector_dot(vertex->point, direction) / vector_length(direction));
+
+		if (lower_bound - radius > upper_limit)
+		{
+			break;
+		}
+
+		bool duplicate = false;
+
+		for (int i = 0; i < saved_count; i++)
+		{
+			if (vertex->index_1 == saved_indices_1[i] && vertex->index_2 == saved_indices_2[i])
+			{
+				duplicate = true;
+
+				break;
+			}
+		}
+
+		if (duplicate)
+		{
+			break;
+		}
+
+		vertex_count++;
+	}
+
+	Vector point_1 = vector_create(0.0, 0.0);
+
+	Vector point_2 = vector_create(0.0, 0.0);
+
+	for (int i = 0; i < vertex_count; i++)
+	{
+		point_1 = vector_add(point_1, vector_multiply(vertices[i].point_1, vertices[i].weight));
+
+		point_2 = vector_add(point_2, vector_multiply(vertices[i].point_2, vertices[i].weight));
+	}
+
+	if (vertex_count == 3)
+	{
+		point_2 = point_1;
+	}
+
+	if (cache != NULL)
+	{
+		cache->count = vertex_count;
+
+		for (int i = 0; i < vertex_count; i++)
+		{
+			cache->indices_1[i] = vertices[i].index_1;
+
+			cache->indices_2[i] = vertices[i].index_2;
+		}
+	}
+
+	double distance = lower_bound - radius > upper_limit ? lower_bound : vector_distance(point_1, point_2);
+
+	if (distance > radius && distance > DISTANCE_EPSILON)
+	{
+		Vector normal = vector_normalize(vector_subtract(point_2, point_1));
+
+		point_1 = vector_add(point_1, vector_multiply(normal, radius_1));
+
+		point_2 = vector_subtract(point_2, vector_multiply(normal, radius_2));
+
+		distance -= radius;
+	}
+	else
+	{
+		point_1 = vector_middle(point_1, point_2);
+
+		point_2 = point_1;
+
+		distance = 0.0;
+	}
+
+	if (closest_1 != NULL)
+	{
+		*closest_1 = point_1;
+	}
+
+	if (closest_2 != NULL)
+	{
+		*closest_2 = point_2;
+	}
+
+	return distance;
+}
+
+static int add_convex_hull_points(Vector a, Vector b, Vector points[], int point_count, Vector hull[])
+{
+	int side_count = 0;
+
+	for (int i = 0; i < point_count; i++)
+	{
+		if (vector_cross(vector_subtract(points[i], a), vector_subtract(b, a)) > 0.0)
+		{
+			Vector point = points[i];
+
+			points[i] = points[side_count];
+
+			points[side_count++] = point;
+		}
+	}
+
+	int farthest_index = -1;
+
+	double farthest_distance = 0.0;
+
+	double farthest_extent = 0.0;
+
+	for (int i = 0; i < side_count; i++)
+	{
+		double distance = vector_cross(vector_subtract(points[i], a), vector_subtract(b, a));
+
+		double extent = vector_dot(vector_subtract(points[i], a), vector_subtract(b, a));
+
+		if (distance > farthest_distance || (distance == farthest_distance && extent > farthest_extent))
+		{
+			farthest_distance = distance;
+
+			farthest_extent = extent;
+
+			farthest_index = i;
+		}
+	}
+
+	if (farthest_index == -1)
+	{
+		return 0;
+	}
+
+	Vector farthest_point = points[farthest_index];
+
+	int point_count_1 = 0;
+
+	for (int i = 0; i < side_count; i++)
+	{
+		if (vector_cross(vector_subtract(points[i], a), vector_subtract(farthest_point, a)) > 0.0)
+		{
+			Vector point = points[i];
+
+			points[i] = points[point_count_1];
+
+			points[point_count_1++] = point;
+		}
+	}
+
+	int point_count_2 = 0;
+
+	for (int i = point_count_1; i < side_count; i++)
+	{
+		if (vector_cross(vector_subtract(points[i], farthest_point), vector_subtract(b, farthest_point)) > 0.0)
+		{
+			Vector point = points[i];
+
+			points[i] = points[point_count_1 + point_count_2];
+
+			points[point_count_1 + point_count_2++] = point;
+		}
+	}
+
+	int hull_count = add_convex_hull_points(a, farthest_point, points, point_count_1, hull);
+
+	hull[hull_count++] = farthest_point;
+
+	hull_count += add_convex_hull_points(farthest_point, b, points + point_count_1, point_count_2, hull + hull_count);
+
+	return hull_count;
+}
+
+static bool test_convex_indexed_polygon(int index_count, const int indices[], const Vector points[])
+{
+	for (int i = index_count - 2, j = index_count - 1, k = 0; k < index_count; i = j, j = k, k++)
+	{
+		Vector a = points[indices[i]];
+
+		Vector b = points[indices[j]];
+
+		Vector c = points[indices[k]];
+
+		if (vector_cross(vector_subtract(b, a), vector_subtract(c, b)) < 0.0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Vector vector_create(double x, double y)
+{
+	Vector v = { x, y };
+
+	return v;
+}
+
+bool vector_equal(Vector v, Vector w)
+{
+	return v.x == w.x && v.y == w.y;
+}
+
+Vector vector_negate(Vector v)
+{
+	return vector_create(-v.x, -v.y);
+}
+
+Vector vector_add(Vector v, Vector w)
+{
+	return vector_create(v.x + w.x, v.y + w.y);
+}
+
+Vector vector_add_value(Vector v, double w)
+{
+	return vector_create(v.x + w, v.y + w);
+}
+
+Vector vector_add_xy(Vector v, double x, double y)
+{
+	return vector_create(v.x + x, v.y + y);
+}
+
+Vector vector_subtract(Vector v, Vector w)
+{
+	return vector_create(v.x - w.x, v.y - w.y);
+}
+
+Vector vector_subtract_value(Vector v, double w)
+{
+	return vector_create(v.x - w, v.y - w);
+}
+
+Vector vector_subtract_xy(Vector v, double x, double y)
+{
+	return vector_create(v.x - x, v.y - y);
+}
+
+Vector vector_multiply(Vector v, double s)
+{
+	return vector_create(v.x * s, v.y * s);
+}
+
+Vector vector_divide(Vector v, double s)
+{
+	return vector_create(v.x / s, v.y / s);
+}
+
+Vector vector_scale(Vector v, Vector s)
+{
+	return vector_create(v.x * s.x, v.y * s.y);
+}
+
+Vector vector_downscale(Vector v, Vector s)
+{
+	return vector_create(v.x / s.x, v.y / s.y);
+}
+
+Vector vector_rotate(Vector v, double a)
+{
+	double s = sin(a);
+
+	double c = cos(a);
+
+	return vector_create(c * v.x - s * v.y, s * v.x + c * v.y);
+}
+
+Vector vector_left(Vector v)
+{
+	return vector_create(-v.y, v.x);
+}
+
+Vector vector_right(Vector v)
+{
+	return vector_create(v.y, -v.x);
+}
+
+Vector vector_normalize(Vector v)
+{
+	return vector_divide(v, vector_length(v));
+}
+
+double vector_length(Vector v)
+{
+	return sqrt(vector_length_squared(v));
+}
+
+double vector_length_squared(Vector v)
+{
+	return square(v.x) + square(v.y);
+}
+
+double vector_distance(Vector v, Vector w)
+{
+	return sqrt(vector_distance_squared(v, w));
+}
+
+double vector_distance_squared(Vector v, Vector w)
+{
+	return square(v.x - w.x) + square(v.y - w.y);
+}
+
+double vector_dot(Vector v, Vector w)
+{
+	return v.x * w.x + v.y * w.y;
+}
+
+double vector_cross(Vector v, Vector w)
+{
+	return v.x * w.y - v.y * w.x;
+}
+
+Vector vector_middle(Vector v, Vector w)
+{
+	return vector_multiply(vector_add(v, w), 0.5);
+}
+
+Transform transform_create(Vector translation, double rotation)
+{
+	Transform transform;
+
+	transform.x = translation.x;
+
+	transform.y = translation.y;
+
+	transform.s = sin(rotation);
+
+	transform.c = cos(rotation);
+
+	return transform;
+}
+
+Transform transform_invert(Transform transform)
+{
+	Transform result;
+
+	result.x = -transform.c * transform.x - transform.s * transform.y;
+
+	result.y =  transform.s * transform.x - transform.c * transform.y;
+
+	result.s = -transform.s;
+
+	result.c =  transform.c;
+
+	return result;
+}
+
+Vector transform_apply(Transform transform, Vector vector)
+{
+	Vector result;
+
+	result.x = transform.c * vector.x - transform.s * vector.y + transform.x;
+
+	result.y = transform.s * vector.x + transform.c * vector.y + transform.y;
+
+	return result;
+}
+
+Matrix matrix_create_identity()
+{
+	Matrix result;
+
+	result.xx = 1.0;
+
+	result.xy = 0.0;
+
+	result.yx = 0.0;
+
+	result.yy = 1.0;
+
+	result.x = 0.0;
+
+	result.y = 0.0;
+
+	return result;
+}
+
+Matrix matrix_create_ortho(const Rect* from, const Rect* to)
+{
+	Matrix result;
+
+	result.xx = (to->max.x - to->min.x) / (from->max.x - from->min.x);
+
+	result.xy = 0.0;
+
+	result.yx = 0.0;
+
+	result.yy = (to->max.y - to->min.y) / (from->max.y - from->min.y);
+
+	result.x = to->min.x - from->min.x * result.xx;
+
+	result.y = to->min.y - from->min.y * result.yy;
+
+	return result;
+}
+
+Matrix matrix_multiply(Matrix matrix_1, Matrix matrix_2)
+{
+	Matrix result;
+
+	result.xx = matrix_1.xx * matrix_2.xx + matrix_1.yx * matrix_2.xy;
+
+	result.xy = matrix_1.xy * matrix_2.xx + matrix_1.yy * matrix_2.xy;
+
+	result.yx = matrix_1.xx * matrix_2.yx + matrix_1.yx * matrix_2.yy;
+
+	result.yy = matrix_1.xy * matrix_2.yx + matrix_1.yy * matrix_2.yy;
+
+	result.x = matrix_1.xx * matrix_2.x + matrix_1.yx * matrix_2.y + matrix_1.x;
+
+	result.y = matrix_1.xy * matrix_2.x + matrix_1.yy * matrix_2.y + matrix_1.y;
+
+	return result;
+}
+
+Matrix matrix_translate(Matrix matrix, Vector translation)
+{
+	matrix.x += matrix.xx * translation.x + matrix.yx * translation.y;
+
+	matrix.y += matrix.xy * translation.x + matrix.yy * translation.y;
+
+	return matrix;
+}
+
+Matrix matrix_rotate(Matrix matrix, double angle)
+{
+	double s = sin(angle);
+
+	double c = cos(angle);
+
+	Matrix result = matrix;
+
+	result.xx = matrix.xx * c + matrix.yx * s;
+
+	result.xy = matrix.xy * c + matrix.yy * s;
+
+	result.yx = matrix.yx * c - matrix.xx * s;
+
+	result.yy = matrix.yy * c - matrix.xy * s;
+
+	return result;
+}
+
+Matrix matrix_scale(Matrix matrix, Vector factor)
+{
+	matrix.xx *= factor.x;
+
+	matrix.xy *= factor.x;
+
+	matrix.yx *= factor.y;
+
+	matrix.yy *= factor.y;
+
+	return matrix;
+}
+
+Matrix matrix_invert(Matrix matrix)
+{
+	double determinant = matrix.xx * matrix.yy - matrix.yx * matrix.xy;
+
+	Matrix result;
+
+	result.xx = matrix.yy / determinant;
+
+	result.xy = -matrix.xy / determinant;
+
+	result.yx = -matrix.yx / determinant;
+
+	result.yy = matrix.xx / determinant;
+
+	result.x = -(result.xx * matrix.x + result.yx * matrix.y);
+
+	result.y = -(result.xy * matrix.x + result.yy * matrix.y);
+
+	return result;
+}
+
+Vector matrix_apply(Matrix matrix, Vector vector)
+{
+	Vector result;
+
+	result.x = matrix.xx * vector.x + matrix.yx * vector.y + matrix.x;
+
+	result.y = matrix.xy * vector.x + matrix.yy * vector.y + matrix.y;
+
+	return result;
+}
+
+Vector segment_get_centroid(const Segment* segment)
+{
+	return vector_middle(segment->a, segment->b);
+}
+
+double segment_get_linear_mass_factor(const Segment* segment)
+{
+	return vector_distance(segment->a, segment->b);
+}
+
+double segment_get_angular_mass_factor(const Segment* segment)
+{
+	return vector_distance_squared(segment->a, segment->b) / 12.0;
+}
+
+Rect segment_get_bounding_rect(const Segment* segment)
+{
+	Rect rect;
+
+	rect.min = vector_create(fmin(segment->a.x, segment->b.x), fmin(segment->a.y, segment->b.y));
+
+	rect.max = vector_create(fmax(segment->a.x, segment->b.x), fmax(segment->a.y, segment->b.y));
+
+	return rect;
+}
+
+double segment_get_bounding_radius(const Segment* segment, Vector center)
+{
+	return sqrt(fmax(vector_distance_squared(segment->a, center), vector_distance_squared(segment->b, center)));
+}
+
+void segment_transform(const Segment* segment, Transform transform, Segment* result)
+{
+	result->a = transform_apply(transform, segment->a);
+
+	result->b = transform_apply(transform, segment->b);
+}
+
+bool segment_test_point(const Segment* segment, Vector point)
+{
+	Vector ab = vector_subtract(segment->b, segment->a);
+
+	return vector_dot(ab, point) >= vector_dot(ab, segment->a) && vector_dot(ab, point) <= vector_dot(ab, segment->b) && vector_cross(ab, point) == vector_cross(ab, segment->a);
+}
+
+Vector circle_get_centroid(const Circle* circle)
+{
+	return circle->center;
+}
+
+double circle_get_linear_mass_factor(const Circle* circle)
+{
+	return square(circle->radius) * M_PI;
+}
+
+double circle_get_angular_mass_factor(const Circle* circle)
+{
+	return square(circle->radius) / 2.0;
+}
+
+Rect circle_get_bounding_rect(const Circle* circle)
+{
+	Rect rect;
+
+	rect.min = vector_subtract_value(circle->center, circle->radius);
+
+	rect.max = vector_add_value(circle->center, circle->radius);
+
+	return rect;
+}
+
+double circle_get_bounding_radius(const Circle* circle, Vector center)
+{
+	return vector_distance(circle->center, center) + circle->radius;
+}
+
+void circle_transform(const Circle* circle, Transform transform, Circle* result)
+{
+	result->center = transform_apply(transform, circle->center);
+
+	result->radius = circle->radius;
+}
+
+bool circle_test_point(const Circle* circle, Vector point)
+{
+	return vector_distance_squared(circle->center, point) <= square(circle->radius);
+}
+
+Vector polygon_get_centroid(const Polygon* polygon)
+{
+	Vector centroid = { 0.0, 0.0 };
+
+	double weight = 0.0;
+
+	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+	{
+		Vector a = polygon->points[i];
+
+		Vector b = polygon->points[j];
+
+		double side_length = vector_distance(a, b);
+
+		centroid = vector_add(centroid, vector_multiply(vector_middle(a, b), side_length));
+
+		weight += side_length;
+	}
+
+	return vector_divide(centroid, weight);
+}
+
+double polygon_get_linear_mass_factor(const Polygon* polygon)
+{
+	double area = 0.0;
+
+	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+	{
+		Vector a = polygon->points[i];
+
+		Vector b = polygon->points[j];
+
+		area += vector_cross(a, b);
+	}
+
+	area /= 2.0;
+
+	return area;
+}
+
+double polygon_get_angular_mass_factor(const Polygon* polygon)
+{
+	double numerator = 0.0;
+
+	double denominator = 0.0;
+
+	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+	{
+		Vector a = polygon->points[i];
+
+		Vector b = polygon->points[j];
+
+		numerator += vector_cross(a, b) * (vector_dot(a, a) + vector_dot(a, b) + vector_dot(b, b));
+
+		denominator += vector_cross(a, b) * 6.0;
+	}
+
+	return numerator / denominator - vector_length_squared(polygon_get_centroid(polygon));
+}
+
+Rect polygon_get_bounding_rect(const Polygon* polygon)
+{
+	Rect rect;
+
+	rect.min.x = INFINITY;
+
+	rect.min.y = INFINITY;
+
+	rect.max.x = -INFINITY;
+
+	rect.max.y = -INFINITY;
+
+	for (int i = 0; i < polygon->point_count; i++)
+	{
+		rect.min.x = fmin(rect.min.x, polygon->points[i].x);
+
+		rect.min.y = fmin(rect.min.y, polygon->points[i].y);
+
+		rect.max.x = fmax(rect.max.x, polygon->points[i].x);
+
+		rect.max.y = fmax(rect.max.y, polygon->points[i].y);
+	}
+
+	return rect;
+}
+
+double polygon_get_bounding_radius(const Polygon* polygon, Vector center)
+{
+	double distance_max = 0.0;
+
+	for (int i = 0; i < polygon->point_count; i++)
+	{
+		distance_max = fmax(distance_max, vector_distance_squared(polygon->points[i], center));
+	}
+
+	return sqrt(distance_max);
+}
+
+void polygon_transform(const Polygon* polygon, Transform transform, Polygon* result)
+{
+	for (int i = 0; i < polygon->point_count; i++)
+	{
+		result->points[i] = transform_apply(transform, polygon->points[i]);
+	}
+}
+
+bool polygon_test_point(const Polygon* polygon, Vector point)
+{
+	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+	{
+		Vector a = polygon->points[i];
+
+		Vector b = polygon->points[j];
+
+		if (vector_cross(vector_subtract(b, a), vector_subtract(point, a)) < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Shape* shape_create_segment(Vector a, Vector b)
+{
+	Shape* shape = malloc(sizeof(Shape));
+
+	shape->type = SHAPE_TYPE_SEGMENT;
+
+	shape->segment.a = a;
+
+	shape->segment.b = b;
+
+	return shape;
+}
+
+Shape* shape_create_circle(Vector center, double radius)
+{
+	Shape* shape = malloc(sizeof(Shape));
+
+	shape->type = SHAPE_TYPE_CIRCLE;
+
+	shape->circle.center = center;
+
+	shape->circle.radius = radius;
+
+	return shape;
+}
+
+Shape* shape_create_polygon(int point_count, const Vector points[])
+{
+	Shape* shape = malloc(sizeof(Shape) + sizeof(Vector) * point_count);
+
+	shape->type = SHAPE_TYPE_POLYGON;
+
+	shape->polygon.point_count = point_count;
+
+	memcpy(shape->polygon.points, points, sizeof(Vector) * point_count);
+	
+	if (polygon_get_linear_mass_factor(&shape->polygon) < 0)
+	{
+		for (int i = 0; i < point_count; i++)
+		{
+			shape->polygon.points[i] = points[point_count - 1 - i];
+		}
+	}
+
+	return shape;
+}
+
+Shape* shape_create_convex_hull(int point_count, const Vector points[])
+{
+	if (point_count <= 0)
+	{
+		return NULL;
+	}
+
+	Vector* hull = malloc(sizeof(Vector) * point_count);
+
+	int hull_count = compute_convex_hull(point_count, points, hull);
+
+	Shape* shape = hull_count < 3 ? shape_create_segment(hull[0], hull[hull_count - 1]) : shape_create_polygon(hull_count, hull);
+
+	free(hull);
+
+	return shape;
+}
+
+Shape** shape_create_convex_decomposition(int point_count, const Vector points[], double weld_distance, int* shape_count)
+{
+	Vector* polygon_points = malloc(sizeof(Vector) * point_count);
+
+	int polygon_point_count = weld_points(point_count, points, weld_distance, polygon_points);
+
+	*shape_count = 0;
+
+	if (polygon_point_count < 3)
+	{
+		free(polygon_points);
+
+		return NULL;
+	}
+
+	double area = 0.0;
+
+	for (int i = polygon_point_count - 1, j = 0; j < polygon_point_count; i = j, j++)
+	{
+		area += vector_cross(polygon_points[i], polygon_points[j]);
+	}
+
+	if (area < 0.0)
+	{
+		for (int i = 0, j = polygon_point_count - 1; i < j; i++, j--)
+		{
+			Vector point = polygon_points[i];
+
+			polygon_points[i] = polygon_points[j];
+
+			polygon_points[j] = point;
+		}
+	}
+
+	int piece_count_max = polygon_point_count - 2;
+
+	int* piece_indices = malloc(sizeof(int) * piece_count_max * polygon_point_count);
+
+	int* piece_sizes = malloc(sizeof(int) * piece_count_max);
+
+	int* merged_indices = malloc(sizeof(int) * polygon_point_count);
+
+	int* remaining_indices = malloc(sizeof(int) * polygon_point_count);
+
+	int remaining_count = polygon_point_count;
+
+	int piece_count = 0;
+
+	for (int i = 0; i < polygon_point_count; i++)
+	{
+		remaining_indices[i] = i;
+	}
+
+	while (remaining_count >= 3)
+	{
+		int ear = 0;
+
+		for (int i = 0; i < remaining_count && remaining_count > 3; i++)
+		{
+			Vector a = polygon_points[remaining_indices[(i + remaining_count - 1) % remaining_count]];
+
+			Vector b = polygon_points[remaining_indices[i]];
+
+			Vector c = polygon_points[remaining_indices[(i + 1) % remaining_count]];
+
+			if (vector_cross(vector_subtract(b, a), vector_subtract(c, b)) <= 0.0)
+			{
+				continue;
+			}
+
+			bool empty = true;
+
+			for (int j = 0; j < remaining_count && empty; j++)
+			{
+				Vector point = polygon_points[remaining_indices[j]];
+
+				if (!vector_equal(point, a) && !vector_equal(point, b) && !vector_equal(point, c) && test_point_triangle(point, a, b, c))
+				{
+					empty = false;
+				}
+			}
+
+			if (empty)
+			{
+				ear = i;
+
+				break;
+			}
+		}
+
+		int* piece = piece_indices + piece_count * polygon_point_count;
+
+		piece[0] = remaining_indices[(ear + remaining_count - 1) % remaining_count];
+
+		piece[1] = remaining_indices[ear];
+
+		piece[2] = remaining_indices[(ear + 1) % remaining_count];
+
+		piece_sizes[piece_count++] = 3;
+
+		memmove(remaining_indices + ear, remaining_indices + ear + 1, sizeof(int) * (remaining_count - ear - 1));
+
+		remaining_count--;
+	}
+
+	for (bool merged = true; merged; )
+	{
+		merged = false;
+
+		for (int i = 0; i < piece_count; i++)
+		{
+			for (int j = i + 1; j < piece_count; j++)
+			{
+				int* piece_1 = piece_indices + i * polygon_point_count;
+
+				int* piece_2 = piece_indices + j * polygon_point_count;
+
+				int edge_1 = -1;
+
+				int edge_2 = -1;
+
+				for (int k = 0; k < piece_sizes[i] && edge_1 == -1; k++)
+				{
+					for (int l = 0; l < piece_sizes[j]; l++)
+					{
+						if (piece_1[k] == piece_2[(l + 1) % piece_sizes[j]] && piece_1[(k + 1) % piece_sizes[i]] == piece_2[l])
+						{
+							edge_1 = k;
+
+							edge_2 = l;
+
+							break;
+						}
+					}
+				}
+
+				if (edge_1 == -1)
+				{
+					continue;
+				}
+
+				int merged_count = 0;
+
+				for (int k = 1; k <= piece_sizes[i]; k++)
+				{
+					merged_indices[merged_count++] = piece_1[(edge_1 + k) % piece_sizes[i]];
+				}
+
+				for (int l = 2; l < piece_sizes[j]; l++)
+				{
+					merged_indices[merged_count++] = piece_2[(edge_2 + l) % piece_sizes[j]];
+				}
+
+				if (!test_convex_indexed_polygon(merged_count, merged_indices, polygon_points))
+				{
+					continue;
+				}
+
+				memcpy(piece_1, merged_indices, sizeof(int) * merged_count);
+
+				piece_sizes[i] = merged_count;
+
+				piece_count--;
+
+				if (j != piece_count)
+				{
+					memcpy(piece_2, piece_indices + piece_count * polygon_point_count, sizeof(int) * piece_sizes[piece_count]);
+				}
+
+				piece_sizes[j] = piece_sizes[piece_count];
+
+				merged = true;
+
+				j--;
+			}
+		}
+	}
+
+	Shape** shapes = malloc(sizeof(Shape*) * piece_count);
+
+	Vector* piece_points = malloc(sizeof(Vector) * polygon_point_count);
+
+	for (int i = 0; i < piece_count; i++)
+	{
+		for (int k = 0; k < piece_sizes[i]; k++)
+		{
+			piece_points[k] = polygon_points[piece_indices[i * polygon_point_count + k]];
+		}
+
+		shapes[i] = shape_create_polygon(piece_sizes[i], piece_points);
+	}
+
+	*shape_count = piece_count;
+
+	free(piece_points);
+
+	free(remaining_indices);
+
+	free(merged_indices);
+
+	free(piece_sizes);
+
+	free(piece_indices);
+
+	free(polygon_points);
+
+	return shapes;
+}
+
+Shape* shape_clone_segment(const Segment* segment)
+{
+	return shape_create_segment(segment->a, segment->b);
+}
+
+Shape* shape_clone_circle(const Circle* circle)
+{
+	return shape_create_circle(circle->center, circle->radius);
+}
+
+Shape* shape_clone_polygon(const Polygon* polygon)
+{
+	return shape_create_polygon(polygon->point_count, polygon->points);
+}
+
+Shape* shape_clone(const Shape* shape)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return shape_clone_segment(&shape->segment);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return shape_clone_circle(&shape->circle);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return shape_clone_polygon(&shape->polygon);
+		}
+	}
+}
+
+void shape_destroy(Shape* shape)
+{
+	free(shape);
+}
+
+size_t shape_get_size(const Shape* shape)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return sizeof(Shape);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return sizeof(Shape) + sizeof(Vector) * shape->polygon.point_count;
+		}
+	}
+}
+
+Vector shape_get_centroid(const Shape* shape)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return segment_get_centroid(&shape->segment);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return circle_get_centroid(&shape->circle);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return polygon_get_centroid(&shape->polygon);
+		}
+	}
+}
+
+double shape_get_linear_mass_factor(const Shape* shape)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return segment_get_linear_mass_factor(&shape->segment);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return circle_get_linear_mass_factor(&shape->circle);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return polygon_get_linear_mass_factor(&shape->polygon);
+		}
+	}
+}
+
+double shape_get_angular_mass_factor(const Shape* shape)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return segment_get_angular_mass_factor(&shape->segment);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return circle_get_angular_mass_factor(&shape->circle);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return polygon_get_angular_mass_factor(&shape->polygon);
+		}
+	}
+}
+
+Rect shape_get_bounding_rect(const Shape* shape)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return segment_get_bounding_rect(&shape->segment);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return circle_get_bounding_rect(&shape->circle);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return polygon_get_bounding_rect(&shape->polygon);
+		}
+	}
+}
+
+double shape_get_bounding_radius(const Shape* shape, Vector center)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return segment_get_bounding_radius(&shape->segment, center);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return circle_get_bounding_radius(&shape->circle, center);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return polygon_get_bounding_radius(&shape->polygon, center);
+		}
+	}
+}
+
+void shape_transform(const Shape* shape, Transform transform, Shape* result)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return segment_transform(&shape->segment, transform, &result->segment);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return circle_transform(&shape->circle, transform, &result->circle);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return polygon_transform(&shape->polygon, transform, &result->polygon);
+		}
+	}
+}
+
+bool shape_test_point(const Shape* shape, Vector point)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return segment_test_point(&shape->segment, point);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return circle_test_point(&shape->circle, point);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return polygon_test_point(&shape->polygon, point);
+		}
+	}
+}
+
+Vector project_onto_line(Vector a, Vector b, Vector p)
+{
+	Vector ab = vector_subtract(b, a);
+
+	double t = vector_dot(ab, vector_subtract(p, a)) / vector_length_squared(ab);
+
+	return vector_add(a, vector_multiply(ab, t));
+}
+
+Vector project_onto_segment(Vector a, Vector b, Vector p)
+{
+	Vector ab = vector_subtract(b, a);
+
+	double t = vector_dot(ab, vector_subtract(p, a)) / vector_length_squared(ab);
+
+	if (t <= 0.0)
+	{
+		return a;
+	}
+
+	if (t >= 1.0)
+	{
+		return b;
+	}
+
+	return vector_add(a, vector_multiply(ab, t));
+}
+
+Rect rect_merge(const Rect* rect_1, const Rect* rect_2)
+{
+	Rect rect;
+
+	rect.min = vector_create(fmin(rect_1->min.x, rect_2->min.x), fmin(rect_1->min.y, rect_2->min.y));
+
+	rect.max = vector_create(fmax(rect_1->max.x, rect_2->max.x), fmax(rect_1->max.y, rect_2->max.y));
+
+	return rect;
+}
+
+Vector rect_get_center(const Rect* rect)
+{
+	return vector_middle(rect->min, rect->max);
+}
+
+Rect rect_transform(const Rect* rect, Transform transform)
+{
+	Vector center = transform_apply(transform, rect_get_center(rect));
+
+	Vector extent = vector_multiply(vector_subtract(rect->max, rect->min), 0.5);
+
+	Vector rotated_extent = vector_create(fabs(transform.c) * extent.x + fabs(transform.s) * extent.y, fabs(transform.s) * extent.x + fabs(transform.c) * extent.y);
+
+	Rect result;
+
+	result.min = vector_subtract(center, rotated_extent);
+
+	result.max = vector_add(center, rotated_extent);
+
+	return result;
+}
+
+bool test_point_rect(Vector point, const Rect* rect)
+{
+	return point.x >= rect->min.x && point.y >= rect->min.y && point.x <= rect->max.x && point.y <= rect->max.y;
+}
+
+bool test_rect_rect(const Rect* rect_1, const Rect* rect_2)
+{
+	return rect_1->min.x <= rect_2->max.x && rect_2->min.x <= rect_1->max.x && rect_1->min.y <= rect_2->max.y && rect_2->min.y <= rect_1->max.y;
+}
+
+bool test_point_triangle(Vector point, Vector a, Vector b, Vector c)
+{
+	return vector_cross(vector_subtract(b, a), vector_subtract(point, a)) >= 0.0 && vector_cross(vector_subtract(c, b), vector_subtract(point, b)) >= 0.0 && vector_cross(vector_subtract(a, c), vector_subtract(point, c)) >= 0.0;
+}
+
+int compute_convex_hull(int point_count, const Vector points[], Vector hull[])
+{
+	if (point_count <= 0)
+	{
+		return 0;
+	}
+
+	Vector* remaining_points = malloc(sizeof(Vector) * point_count);
+
+	memcpy(remaining_points, points, sizeof(Vector) * point_count);
+
+	Vector left = points[0];
+
+	Vector right = points[0];
+
+	for (int i = 1; i < point_count; i++)
+	{
+		if (points[i].x < left.x || (points[i].x == left.x && points[i].y < left.y))
+		{
+			left = points[i];
+		}
+
+		if (points[i].x > right.x || (points[i].x == right.x && points[i].y > right.y))
+		{
+			right = points[i];
+		}
+	}
+
+	int hull_count = 0;
+
+	hull[hull_count++] = left;
+
+	if (vector_equal(left, right))
+	{
+		free(remaining_points);
+
+		return hull_count;
+	}
+
+	hull_count += add_convex_hull_points(left, right, remaining_points, point_count, hull + hull_count);
+
+	hull[hull_count++] = right;
+
+	hull_count += add_convex_hull_points(right, left, remaining_points, point_count, hull + hull_count);
+
+	free(remaining_points);
+
+	return hull_count;
+}
+
+int weld_points(int point_count, const Vector points[], double weld_distance, Vector result[])
+{
+	int result_count = 0;
+
+	for (int i = 0; i < point_count; i++)
+	{
+		if (result_count == 0 || vector_distance(points[i], result[result_count - 1]) > weld_distance)
+		{
+			result[result_count++] = points[i];
+		}
+	}
+
+	while (result_count > 1 && vector_distance(result[result_count - 1], result[0]) <= weld_distance)
+	{
+		result_count--;
+	}
+
+	for (bool welded = true; welded && result_count > 3; )
+	{
+		welded = false;
+
+		for (int i = 0; i < result_count && result_count > 3; i++)
+		{
+			Vector prev = result[(i + result_count - 1) % result_count];
+
+			Vector next = result[(i + 1) % result_count];
+
+			if (vector_distance(result[i], project_onto_segment(prev, next, result[i])) <= weld_distance)
+			{
+				memmove(result + i, result + i + 1, sizeof(Vector) * (result_count - i - 1));
+
+				result_count--;
+
+				welded = true;
+			}
+		}
+	}
+
+	return result_count;
+}
+
+bool test_ray_rect(const Ray* ray, double fraction, const Rect* rect)
+{
+	double lower = 0.0;
+
+	double upper = fraction;
+
+	double origins[2] = { ray->origin.x, ray->origin.y };
+
+	double directions[2] = { ray->direction.x, ray->direction.y };
+
+	double mins[2] = { rect->min.x, rect->min.y };
+
+	double maxs[2] = { rect->max.x, rect->max.y };
+
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (directions[axis] == 0.0)
+		{
+			if (origins[axis] < mins[axis] || origins[axis] > maxs[axis])
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		double t_1 = (mins[axis] - origins[axis]) / directions[axis];
+
+		double t_2 = (maxs[axis] - origins[axis]) / directions[axis];
+
+		lower = fmax(lower, fmin(t_1, t_2));
+
+		upper = fmin(upper, fmax(t_1, t_2));
+
+		if (lower > upper)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Rect ray_packet_get_bounding_rect(const Ray_Packet* packet, const Ray_Packet_Hit* hit)
+{
+	Rect rect;
+
+	rect.min = vector_create(INFINITY, INFINITY);
+
+	rect.max = vector_create(-INFINITY, -INFINITY);
+
+	for (int i = 0; i < RAY_PACKET_SIZE; i++)
+	{
+		double end_x = packet->origin_x[i] + packet->direction_x[i] * hit->fraction[i];
+
+		double end_y = packet->origin_y[i] + packet->direction_y[i] * hit->fraction[i];
+
+		rect.min.x = fmin(rect.min.x, fmin(packet->origin_x[i], end_x));
+
+		rect.min.y = fmin(rect.min.y, fmin(packet->origin_y[i], end_y));
+
+		rect.max.x = fmax(rect.max.x, fmax(packet->origin_x[i], end_x));
+
+		rect.max.y = fmax(rect.max.y, fmax(packet->origin_y[i], end_y));
+	}
+
+	return rect;
+}
+
+bool raycast_shape(const Shape* shape, const Ray* ray, Ray_Hit* hit)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return raycast_segment(&shape->segment, ray, hit);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return raycast_circle(&shape->circle, ray, hit);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return raycast_polygon(&shape->polygon, ray, hit);
+		}
+	}
+}
+
+bool raycast_segment(const Segment* segment, const Ray* ray, Ray_Hit* hit)
+{
+	Vector side = vector_subtract(segment->b, segment->a);
+
+	double denominator = vector_cross(ray->direction, side);
+
+	if (denominator == 0.0)
+	{
+		return false;
+	}
+
+	Vector offset = vector_subtract(segment->a, ray->origin);
+
+	double fraction = vector_cross(offset, side) / denominator;
+
+	double position = vector_cross(offset, ray->direction) / denominator;
+
+	if (fraction < 0.0 || fraction > 1.0 || position < 0.0 || position > 1.0)
+	{
+		return false;
+	}
+
+	hit->fraction = fraction;
+
+	hit->normal = vector_normalize(denominator > 0.0 ? vector_left(side) : vector_right(side));
+
+	return true;
+}
+
+bool raycast_circle(const Circle* circle, const Ray* ray, Ray_Hit* hit)
+{
+	Vector offset = vector_subtract(ray->origin, circle->center);
+
+	double a = vector_length_squared(ray->direction);
+
+	double b = vector_dot(offset, ray->direction);
+
+	double c = vector_length_squared(offset) - square(circle->radius);
+
+	double discriminant = b * b - a * c;
+
+	if (c < 0.0 || b > 0.0 || discriminant < 0.0 || a == 0.0)
+	{
+		return false;
+	}
+
+	double fraction = (-b - sqrt(discriminant)) / a;
+
+	if (fraction > 1.0)
+	{
+		return false;
+	}
+
+	hit->fraction = fraction;
+
+	hit->normal = vector_normalize(vector_add(offset, vector_multiply(ray->direction, fraction)));
+
+	return true;
+}
+
+bool raycast_polygon(const Polygon* polygon, const Ray* ray, Ray_Hit* hit)
+{
+	double lower = 0.0;
+
+	double upper = 1.0;
+
+	int lower_index = -1;
+
+	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+	{
+		Vector a = polygon->points[i];
+
+		Vector normal = vector_right(vector_subtract(polygon->points[j], a));
+
+		double numerator = vector_dot(normal, vector_subtract(a, ray->origin));
+
+		double denominator = vector_dot(normal, ray->direction);
+
+		if (denominator == 0.0)
+		{
+			if (numerator < 0.0)
+			{
+				return false;
+			}
+		}
+		else if (denominator < 0.0)
+		{
+			if (numerator / denominator > lower)
+			{
+				lower = numerator / denominator;
+
+				lower_index = i;
+			}
+		}
+		else
+		{
+			upper = fmin(upper, numerator / denominator);
+		}
+
+		if (upper < lower)
+		{
+			return false;
+		}
+	}
+
+	if (lower_index == -1)
+	{
+		return false;
+	}
+
+	hit->fraction = lower;
+
+	hit->normal = vector_normalize(vector_right(vector_subtract(polygon->points[(lower_index + 1) % polygon->point_count], polygon->points[lower_index])));
+
+	return true;
+}
+
+void raycast_shape_packet(const Shape* shape, const Ray_Packet* packet, Ray_Packet_Hit* hit)
+{
+	switch (shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			return raycast_segment_packet(&shape->segment, packet, hit);
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			return raycast_circle_packet(&shape->circle, packet, hit);
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			return raycast_polygon_packet(&shape->polygon, packet, hit);
+		}
+	}
+}
+
+void raycast_segment_packet(const Segment* segment, const Ray_Packet* packet, Ray_Packet_Hit* hit)
+{
+	double side_x = segment->b.x - segment->a.x;
+
+	double side_y = segment->b.y - segment->a.y;
+
+	double side_length = sqrt(side_x * side_x + side_y * side_y);
+
+	int i = 0;
+
+#ifdef __SSE2__
+
+	__m128d zero_2 = _mm_setzero_pd();
+
+	__m128d one_2 = _mm_set1_pd(1.0);
+
+	__m128d sign_2 = _mm_set1_pd(-0.0);
+
+	__m128d side_x_2 = _mm_set1_pd(side_x);
+
+	__m128d side_y_2 = _mm_set1_pd(side_y);
+
+	__m128d normal_x_2 = _mm_set1_pd(side_y / side_length);
+
+	__m128d normal_y_2 = _mm_set1_pd(-side_x / side_length);
+
+	for (; i + 2 <= RAY_PACKET_SIZE; i += 2)
+	{
+		__m128d direction_x = _mm_loadu_pd(packet->direction_x + i);
+
+		__m128d direction_y = _mm_loadu_pd(packet->direction_y + i);
+
+		__m128d denominator = _mm_sub_pd(_mm_mul_pd(direction_x, side_y_2), _mm_mul_pd(direction_y, side_x_2));
+
+		__m128d offset_x = _mm_sub_pd(_mm_set1_pd(segment->a.x), _mm_loadu_pd(packet->origin_x + i));
+
+		__m128d offset_y = _mm_sub_pd(_mm_set1_pd(segment->a.y), _mm_loadu_pd(packet->origin_y + i));
+
+		__m128d fraction = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(offset_x, side_y_2), _mm_mul_pd(offset_y, side_x_2)), denominator);
+
+		__m128d position = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(offset_x, direction_y), _mm_mul_pd(offset_y, direction_x)), denominator);
+
+		__m128d flip = _mm_and_pd(_mm_cmpgt_pd(denominator, zero_2), sign_2);
+
+		__m128d hit_fraction = _mm_loadu_pd(hit->fraction + i);
+
+		__m128d is_hit = _mm_and_pd(_mm_and_pd(_mm_cmpneq_pd(denominator, zero_2), _mm_cmpge_pd(fraction, zero_2)), _mm_and_pd(_mm_cmplt_pd(fraction, hit_fraction), _mm_and_pd(_mm_cmpge_pd(position, zero_2), _mm_cmple_pd(position, one_2))));
+
+		_mm_storeu_pd(hit->fraction + i, raycast_select(is_hit, fraction, hit_fraction));
+
+		_mm_storeu_pd(hit->normal_x + i, raycast_select(is_hit, _mm_xor_pd(normal_x_2, flip), _mm_loadu_pd(hit->normal_x + i)));
+
+		_mm_storeu_pd(hit->normal_y + i, raycast_select(is_hit, _mm_xor_pd(normal_y_2, flip), _mm_loadu_pd(hit->normal_y + i)));
+	}
+
+#endif
+
+	for (; i < RAY_PACKET_SIZE; i++)
+	{
+		double denominator = packet->direction_x[i] * side_y - packet->direction_y[i] * side_x;
+
+		double offset_x = segment->a.x - packet->origin_x[i];
+
+		double offset_y = segment->a.y - packet->origin_y[i];
+
+		double fraction = (offset_x * side_y - offset_y * side_x) / denominator;
+
+		double position = (offset_x * packet->direction_y[i] - offset_y * packet->direction_x[i]) / denominator;
+
+		double sign = denominator > 0.0 ? -1.0 : 1.0;
+
+		bool is_hit = denominator != 0.0 && fraction >= 0.0 && fraction < hit->fraction[i] && position >= 0.0 && position <= 1.0;
+
+		hit->fraction[i] = is_hit ? fraction : hit->fraction[i];
+
+		hit->normal_x[i] = is_hit ? sign * side_y / side_length : hit->normal_x[i];
+
+		hit->normal_y[i] = is_hit ? -sign * side_x / side_length : hit->normal_y[i];
+	}
+}
+
+void raycast_circle_packet(const Circle* circle, const Ray_Packet* packet, Ray_Packet_Hit* hit)
+{
+	double radius_squared = square(circle->radius);
+
+	int i = 0;
+
+#ifdef __SSE2__
+
+	__m128d zero_2 = _mm_setzero_pd();
+
+	__m128d radius_2 = _mm_set1_pd(circle->radius);
+
+	for (; i + 2 <= RAY_PACKET_SIZE; i += 2)
+	{
+		__m128d direction_x = _mm_loadu_pd(packet->direction_x + i);
+
+		__m128d direction_y = _mm_loadu_pd(packet->direction_y + i);
+
+		__m128d offset_x = _mm_sub_pd(_mm_loadu_pd(packet->origin_x + i), _mm_set1_pd(circle->center.x));
+
+		__m128d offset_y = _mm_sub_pd(_mm_loadu_pd(packet->origin_y + i), _mm_set1_pd(circle->center.y));
+
+		__m128d a = _mm_add_pd(_mm_mul_pd(direction_x, direction_x), _mm_mul_pd(direction_y, direction_y));
+
+		__m128d b = _mm_add_pd(_mm_mul_pd(offset_x, direction_x), _mm_mul_pd(offset_y, direction_y));
+
+		__m128d c = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(offset_x, offset_x), _mm_mul_pd(offset_y, offset_y)), _mm_set1_pd(radius_squared));
+
+		__m128d discriminant = _mm_sub_pd(_mm_mul_pd(b, b), _mm_mul_pd(a, c));
+
+		__m128d fraction = _mm_div_pd(_mm_sub_pd(_mm_sub_pd(zero_2, b), _mm_sqrt_pd(_mm_max_pd(discriminant, zero_2))), a);
+
+		__m128d hit_fraction = _mm_loadu_pd(hit->fraction + i);
+
+		__m128d is_hit = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(c, zero_2), _mm_cmple_pd(b, zero_2)), _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(discriminant, zero_2), _mm_cmpneq_pd(a, zero_2)), _mm_cmplt_pd(fraction, hit_fraction)));
+
+		_mm_storeu_pd(hit->fraction + i, raycast_select(is_hit, fraction, hit_fraction));
+
+		_mm_storeu_pd(hit->normal_x + i, raycast_select(is_hit, _mm_div_pd(_mm_add_pd(offset_x, _mm_mul_pd(direction_x, fraction)), radius_2), _mm_loadu_pd(hit->normal_x + i)));
+
+		_mm_storeu_pd(hit->normal_y + i, raycast_select(is_hit, _mm_div_pd(_mm_add_pd(offset_y, _mm_mul_pd(direction_y, fraction)), radius_2), _mm_loadu_pd(hit->normal_y + i)));
+	}
+
+#endif
+
+	for (; i < RAY_PACKET_SIZE; i++)
+	{
+		double offset_x = packet->origin_x[i] - circle->center.x;
+
+		double offset_y = packet->origin_y[i] - circle->center.y;
+
+		double a = packet->direction_x[i] * packet->direction_x[i] + packet->direction_y[i] * packet->direction_y[i];
+
+		double b = offset_x * packet->direction_x[i] + offset_y * packet->direction_y[i];
+
+		double c = offset_x * offset_x + offset_y * offset_y - radius_squared;
+
+		double discriminant = b * b - a * c;
+
+		double fraction = (-b - sqrt(fmax(discriminant, 0.0))) / a;
+
+		bool is_hit = c >= 0.0 && b <= 0.0 && discriminant >= 0.0 && a != 0.0 && fraction < hit->fraction[i];
+
+		hit->fraction[i] = is_hit ? fraction : hit->fraction[i];
+
+		hit->normal_x[i] = is_hit ? (offset_x + packet->direction_x[i] * fraction) / circle->radius : hit->normal_x[i];
+
+		hit->normal_y[i] = is_hit ? (offset_y + packet->direction_y[i] * fraction) / circle->radius : hit->normal_y[i];
 	}
 }
 
-bool polygon_test_point(const Polygon* polygon, Vector point)
+void raycast_polygon_packet(const Polygon* polygon, const Ray_Packet* packet, Ray_Packet_Hit* hit)
 {
-	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+	double lower[RAY_PACKET_SIZE];
+
+	double upper[RAY_PACKET_SIZE];
+
+	int lower_index[RAY_PACKET_SIZE];
+
+	int i = 0;
+
+#ifdef __SSE2__
+
+	__m128d zero_2 = _mm_setzero_pd();
+
+	for (; i + 2 <= RAY_PACKET_SIZE; i += 2)
 	{
-		Vector a = polygon->points[i];
+		__m128d origin_x = _mm_loadu_pd(packet->origin_x + i);
 
-		Vector b = polygon->points[j];
+		__m128d origin_y = _mm_loadu_pd(packet->origin_y + i);
 
-		if (vector_cross(vector_subtract(b, a), vector_subtract(point, a)) < 0)
+		__m128d direction_x = _mm_loadu_pd(packet->direction_x + i);
+
+		__m128d direction_y = _mm_loadu_pd(packet->direction_y + i);
+
+		__m128d lower_2 = zero_2;
+
+		__m128d upper_2 = _mm_loadu_pd(hit->fraction + i);
+
+		__m128d lower_index_2 = _mm_set1_pd(-1.0);
+
+		for (int k = polygon->point_count - 1, l = 0; l < polygon->point_count; k = l, l++)
 		{
-			return false;
+			Vector a = polygon->points[k];
+
+			__m128d normal_x = _mm_set1_pd(polygon->points[l].y - a.y);
+
+			__m128d normal_y = _mm_set1_pd(a.x - polygon->points[l].x);
+
+			__m128d numerator = _mm_add_pd(_mm_mul_pd(normal_x, _mm_sub_pd(_mm_set1_pd(a.x), origin_x)), _mm_mul_pd(normal_y, _mm_sub_pd(_mm_set1_pd(a.y), origin_y)));
+
+			__m128d denominator = _mm_add_pd(_mm_mul_pd(normal_x, direction_x), _mm_mul_pd(normal_y, direction_y));
+
+			__m128d fraction = _mm_div_pd(numerator, denominator);
+
+			__m128d entering = _mm_and_pd(_mm_cmplt_pd(denominator, zero_2), _mm_cmpgt_pd(fraction, lower_2));
+
+			lower_index_2 = raycast_select(entering, _mm_set1_pd(k), lower_index_2);
+
+			lower_2 = raycast_select(entering, fraction, lower_2);
+
+			upper_2 = raycast_select(_mm_cmpgt_pd(denominator, zero_2), _mm_min_pd(fraction, upper_2), upper_2);
+
+			upper_2 = raycast_select(_mm_and_pd(_mm_cmpeq_pd(denominator, zero_2), _mm_cmplt_pd(numerator, zero_2)), _mm_set1_pd(-1.0), upper_2);
 		}
+
+		_mm_storeu_pd(lower + i, lower_2);
+
+		_mm_storeu_pd(upper + i, upper_2);
+
+		lower_index[i] = _mm_cvtsd_si32(lower_index_2);
+
+		lower_index[i + 1] = _mm_cvtsd_si32(_mm_unpackhi_pd(lower_index_2, lower_index_2));
 	}
 
-	return true;
-}
+#endif
 
-Shape* shape_create_segment(Vector a, Vector b)
-{
-	Shape* shape = malloc(sizeof(Shape));
+	for (; i < RAY_PACKET_SIZE; i++)
+	{
+		lower[i] = 0.0;
 
-	shape->type = SHAPE_TYPE_SEGMENT;
+		upper[i] = hit->fraction[i];
 
-	shape->segment.a = a;
+		lower_index[i] = -1;
 
-	shape->segment.b = b;
+		for (int k = polygon->point_count - 1, l = 0; l < polygon->point_count; k = l, l++)
+		{
+			Vector a = polygon->points[k];
 
-	return shape;
-}
+			double normal_x = polygon->points[l].y - a.y;
 
-Shape* shape_create_circle(Vector center, double radius)
-{
-	Shape* shape = malloc(sizeof(Shape));
+			double normal_y = a.x - polygon->points[l].x;
 
-	shape->type = SHAPE_TYPE_CIRCLE;
+			double numerator = normal_x * (a.x - packet->origin_x[i]) + normal_y * (a.y - packet->origin_y[i]);
 
-	shape->circle.center = center;
+			double denominator = normal_x * packet->direction_x[i] + normal_y * packet->direction_y[i];
 
-	shape->circle.radius = radius;
+			double fraction = numerator / denominator;
 
-	return shape;
-}
+			bool entering = denominator < 0.0 && fraction > lower[i];
 
-Shape* shape_create_polygon(int point_count, const Vector points[])
-{
-	Shape* shape = malloc(sizeof(Shape) + sizeof(Vector) * point_count);
+			lower_index[i] = entering ? k : lower_index[i];
 
-	shape->type = SHAPE_TYPE_POLYGON;
+			lower[i] = entering ? fraction : lower[i];
 
-	shape->polygon.point_count = point_count;
+			upper[i] = denominator > 0.0 ? fmin(upper[i], fraction) : upper[i];
 
-	memcpy(shape->polygon.points, points, sizeof(Vector) * point_count);
-	
-	if (polygon_get_linear_mass_factor(&shape->polygon) < 0)
+			upper[i] = denominator == 0.0 && numerator < 0.0 ? -1.0 : upper[i];
+		}
+	}
+
+	for (i = 0; i < RAY_PACKET_SIZE; i++)
 	{
-		for (int i = 0; i < point_count; i++)
+		if (lower_index[i] == -1 || upper[i] < lower[i] || lower[i] >= hit->fraction[i])
 		{
-			shape->polygon.points[i] = points[point_count - 1 - i];
+			continue;
 		}
-	}
 
-	return shape;
+		Vector normal = vector_normalize(vector_right(vector_subtract(polygon->points[(lower_index[i] + 1) % polygon->point_count], polygon->points[lower_index[i]])));
+
+		hit->fraction[i] = lower[i];
+
+		hit->normal_x[i] = normal.x;
+
+		hit->normal_y[i] = normal.y;
+	}
 }
 
-Shape* shape_clone_segment(const Segment* segment)
+bool test_shape_distance(const Shape* shape_1, const Shape* shape_2, double distance)
 {
-	return shape_create_segment(segment->a, segment->b);
+	return compute_distance(shape_1, shape_2, NULL, distance, distance, NULL, NULL) <= distance;
 }
 
-Shape* shape_clone_circle(const Circle* circle)
+double shape_distance(const Shape* shape_1, const Shape* shape_2, Vector* closest_1, Vector* closest_2)
 {
-	return shape_create_circle(circle->center, circle->radius);
+	return compute_distance(shape_1, shape_2, NULL, -1.0, INFINITY, closest_1, closest_2);
 }
 
-Shape* shape_clone_polygon(const Polygon* polygon)
+double shape_distance_cached(const Shape* shape_1, const Shape* shape_2, Distance_Cache* cache, Vector* closest_1, Vector* closest_2)
 {
-	return shape_create_polygon(polygon->point_count, polygon->points);
+	return compute_distance(shape_1, shape_2, cache, -1.0, INFINITY, closest_1, closest_2);
 }
 
-Shape* shape_clone(const Shape* shape)
+void shape_distances(int pair_count, const Shape* const shapes_1[], const Shape* const shapes_2[], Distance_Cache caches[], double distances[], Vector closests_1[], Vector closests_2[])
 {
-	switch (shape->type)
+	for (int i = 0; i < pair_count; i++)
 	{
-		case SHAPE_TYPE_SEGMENT:
-		{
-			return shape_clone_segment(&shape->segment);
-		}
-		case SHAPE_TYPE_CIRCLE:
-		{
-			return shape_clone_circle(&shape->circle);
-		}
-		case SHAPE_TYPE_POLYGON:
-		{
-			return shape_clone_polygon(&shape->polygon);
-		}
+		distances[i] = compute_distance(shapes_1[i], shapes_2[i], &caches[i], -1.0, INFINITY, &closests_1[i], &closests_2[i]);
 	}
 }
 
-void shape_destroy(Shape* shape)
-{
-	free(shape);
-}
-
-Vector shape_get_centroid(const Shape* shape)
+bool overlap_shapes(const Shape* shape_1, const Shape* shape_2)
 {
-	switch (shape->type)
+	switch (shape_1->type * SHAPE_TYPE_COUNT + shape_2->type)
 	{
-		case SHAPE_TYPE_SEGMENT:
+		case SHAPE_TYPE_SEGMENT * SHAPE_TYPE_COUNT + SHAPE_TYPE_SEGMENT:
 		{
-			return segment_get_centroid(&shape->segment);
+			return overlap_segments(&shape_1->segment, &shape_2->segment);
 		}
-		case SHAPE_TYPE_CIRCLE:
+		case SHAPE_TYPE_SEGMENT * SHAPE_TYPE_COUNT + SHAPE_TYPE_CIRCLE:
 		{
-			return circle_get_centroid(&shape->circle);
+			return overlap_segment_circle(&shape_1->segment, &shape_2->circle);
 		}
-		case SHAPE_TYPE_POLYGON:
+		case SHAPE_TYPE_SEGMENT * SHAPE_TYPE_COUNT + SHAPE_TYPE_POLYGON:
 		{
-			return polygon_get_centroid(&shape->polygon);
+			return overlap_segment_polygon(&shape_1->segment, &shape_2->polygon);
 		}
-	}
-}
-
-double shape_get_linear_mass_factor(const Shape* shape)
-{
-	switch (shape->type)
-	{
-		case SHAPE_TYPE_SEGMENT:
+		case SHAPE_TYPE_CIRCLE * SHAPE_TYPE_COUNT + SHAPE_TYPE_SEGMENT:
 		{
-			return segment_get_linear_mass_factor(&shape->segment);
+			return overlap_circle_segment(&shape_1->circle, &shape_2->segment);
 		}
-		case SHAPE_TYPE_CIRCLE:
+		case SHAPE_TYPE_CIRCLE * SHAPE_TYPE_COUNT + SHAPE_TYPE_CIRCLE:
 		{
-			return circle_get_linear_mass_factor(&shape->circle);
+			return overlap_circles(&shape_1->circle, &shape_2->circle);
 		}
-		case SHAPE_TYPE_POLYGON:
+		case SHAPE_TYPE_CIRCLE * SHAPE_TYPE_COUNT + SHAPE_TYPE_POLYGON:
 		{
-			return polygon_get_linear_mass_factor(&shape->polygon);
+			return overlap_circle_polygon(&shape_1->circle, &shape_2->polygon);
 		}
-	}
-}
-
-double shape_get_angular_mass_factor(const Shape* shape)
-{
-	switch (shape->type)
-	{
-		case SHAPE_TYPE_SEGMENT:
+		case SHAPE_TYPE_POLYGON * SHAPE_TYPE_COUNT + SHAPE_TYPE_SEGMENT:
 		{
-			return segment_get_angular_mass_factor(&shape->segment);
+			return overlap_polygon_segment(&shape_1->polygon, &shape_2->segment);
 		}
-		case SHAPE_TYPE_CIRCLE:
+		case SHAPE_TYPE_POLYGON * SHAPE_TYPE_COUNT + SHAPE_TYPE_CIRCLE:
 		{
-			return circle_get_angular_mass_factor(&shape->circle);
+			return overlap_polygon_circle(&shape_1->polygon, &shape_2->circle);
 		}
-		case SHAPE_TYPE_POLYGON:
+		case SHAPE_TYPE_POLYGON * SHAPE_TYPE_COUNT + SHAPE_TYPE_POLYGON:
 		{
-			return polygon_get_angular_mass_factor(&shape->polygon);
+			return overlap_polygons(&shape_1->polygon, &shape_2->polygon);
 		}
 	}
 }
 
-Rect shape_get_bounding_rect(const Shape* shape)
+bool overlap_segments(const Segment* segment_1, const Segment* segment_2)
 {
-	switch (shape->type)
+	Vector side_1 = vector_subtract(segment_1->b, segment_1->a);
+
+	double cross_1 = vector_cross(side_1, vector_subtract(segment_2->a, segment_1->a));
+
+	double cross_2 = vector_cross(side_1, vector_subtract(segment_2->b, segment_1->a));
+
+	if ((cross_1 > 0.0 && cross_2 > 0.0) || (cross_1 < 0.0 && cross_2 < 0.0))
 	{
-		case SHAPE_TYPE_SEGMENT:
-		{
-			return segment_get_bounding_rect(&shape->segment);
-		}
-		case SHAPE_TYPE_CIRCLE:
-		{
-			return circle_get_bounding_rect(&shape->circle);
-		}
-		case SHAPE_TYPE_POLYGON:
-		{
-			return polygon_get_bounding_rect(&shape->polygon);
-		}
+		return false;
+	}
+
+	Vector side_2 = vector_subtract(segment_2->b, segment_2->a);
+
+	double cross_3 = vector_cross(side_2, vector_subtract(segment_1->a, segment_2->a));
+
+	double cross_4 = vector_cross(side_2, vector_subtract(segment_1->b, segment_2->a));
+
+	if ((cross_3 > 0.0 && cross_4 > 0.0) || (cross_3 < 0.0 && cross_4 < 0.0))
+	{
+		return false;
 	}
+
+	if (cross_1 == 0.0 && cross_2 == 0.0)
+	{
+		double t_a = vector_dot(side_1, vector_subtract(segment_2->a, segment_1->a));
+
+		double t_b = vector_dot(side_1, vector_subtract(segment_2->b, segment_1->a));
+
+		return fmax(t_a, t_b) >= 0.0 && fmin(t_a, t_b) <= vector_length_squared(side_1);
+	}
+
+	return true;
 }
 
-void shape_transform(const Shape* shape, Transform transform, Shape* result)
+bool overlap_circles(const Circle* circle_1, const Circle* circle_2)
 {
-	switch (shape->type)
+	return vector_distance_squared(circle_1->center, circle_2->center) <= square(circle_1->radius + circle_2->radius);
+}
+
+bool overlap_polygons(const Polygon* polygon_1, const Polygon* polygon_2)
+{
+	for (int i = polygon_1->point_count - 1, j = 0; j < polygon_1->point_count; i = j, j++)
 	{
-		case SHAPE_TYPE_SEGMENT:
-		{
-			return segment_transform(&shape->segment, transform, &result->segment);
-		}
-		case SHAPE_TYPE_CIRCLE:
+		Vector a = polygon_1->points[i];
+
+		Vector axis = vector_right(vector_subtract(polygon_1->points[j], a));
+
+		bool separated = true;
+
+		for (int k = 0; k < polygon_2->point_count && separated; k++)
 		{
-			return circle_transform(&shape->circle, transform, &result->circle);
+			separated = vector_dot(vector_subtract(a, polygon_2->points[k]), axis) < 0.0;
 		}
-		case SHAPE_TYPE_POLYGON:
+
+		if (separated)
 		{
-			return polygon_transform(&shape->polygon, transform, &result->polygon);
+			return false;
 		}
 	}
-}
 
-bool shape_test_point(const Shape* shape, Vector point)
-{
-	switch (shape->type)
+	for (int i = polygon_2->point_count - 1, j = 0; j < polygon_2->point_count; i = j, j++)
 	{
-		case SHAPE_TYPE_SEGMENT:
-		{
-			return segment_test_point(&shape->segment, point);
-		}
-		case SHAPE_TYPE_CIRCLE:
+		Vector a = polygon_2->points[i];
+
+		Vector axis = vector_right(vector_subtract(polygon_2->points[j], a));
+
+		bool separated = true;
+
+		for (int k = 0; k < polygon_1->point_count && separated; k++)
 		{
-			return circle_test_point(&shape->circle, point);
+			separated = vector_dot(vector_subtract(a, polygon_1->points[k]), axis) < 0.0;
 		}
-		case SHAPE_TYPE_POLYGON:
+
+		if (separated)
 		{
-			return polygon_test_point(&shape->polygon, point);
+			return false;
 		}
 	}
+
+	return true;
 }
 
-Vector project_onto_line(Vector a, Vector b, Vector p)
+bool overlap_segment_circle(const Segment* segment, const Circle* circle)
 {
-	Vector ab = vector_subtract(b, a);
+	return vector_distance_squared(circle->center, project_onto_segment(segment->a, segment->b, circle->center)) <= square(circle->radius);
+}
 
-	double t = vector_dot(ab, vector_subtract(p, a)) / vector_length_squared(ab);
+bool overlap_segment_polygon(const Segment* segment, const Polygon* polygon)
+{
+	Polygon* polygon_of_segment = _alloca(sizeof(Polygon) + 2 * sizeof(Vector));
 
-	return vector_add(a, vector_multiply(ab, t));
+	polygon_of_segment->point_count = 2;
+
+	polygon_of_segment->points[0] = segment->a;
+
+	polygon_of_segment->points[1] = segment->b;
+
+	return overlap_polygons(polygon_of_segment, polygon);
 }
 
-Vector project_onto_segment(Vector a, Vector b, Vector p)
+bool overlap_circle_polygon(const Circle* circle, const Polygon* polygon)
 {
-	Vector ab = vector_subtract(b, a);
+	bool inside = true;
 
-	double t = vector_dot(ab, vector_subtract(p, a)) / vector_length_squared(ab);
+	double radius_squared = square(circle->radius);
 
-	if (t <= 0.0)
+	for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
 	{
-		return a;
-	}
+		Vector a = polygon->points[i];
 
-	if (t >= 1.0)
-	{
-		return b;
+		Vector b = polygon->points[j];
+
+		if (vector_distance_squared(circle->center, project_onto_segment(a, b, circle->center)) <= radius_squared)
+		{
+			return true;
+		}
+
+		if (vector_cross(vector_subtract(b, a), vector_subtract(circle->center, a)) < 0.0)
+		{
+			inside = false;
+		}
 	}
 
-	return vector_add(a, vector_multiply(ab, t));
+	return inside;
 }
 
-bool test_point_rect(Vector point, const Rect* rect)
+bool overlap_circle_segment(const Circle* circle, const Segment* segment)
 {
-	return point.x >= rect->min.x && point.y >= rect->min.y && point.x <= rect->max.x && point.y <= rect->max.y;
+	return overlap_segment_circle(segment, circle);
+}
+
+bool overlap_polygon_segment(const Polygon* polygon, const Segment* segment)
+{
+	return overlap_segment_polygon(segment, polygon);
+}
+
+bool overlap_polygon_circle(const Polygon* polygon, const Circle* circle)
+{
+	return overlap_circle_polygon(circle, polygon);
 }
 
 bool collide_shapes(const Shape* shape_1, const Shape* shape_2, Collision* collision)
@@ -8,12 +8,20 @@
 
 #include <string.h>
 
+#define RAY_PACKET_SIZE 4
+
+#define DISTANCE_ITERATION_COUNT_MAX 20
+
+#define DISTANCE_EPSILON 1e-12
+
 typedef enum Shape_Type Shape_Type;
 
 typedef struct Vector Vector;
 
 typedef struct Transform Transform;
 
+typedef struct Matrix Matrix;
+
 typedef struct Segment Segment;
 
 typedef struct Circle Circle;
@@ -26,6 +34,16 @@ typedef struct Rect Rect;
 
 typedef struct Collision Collision;
 
+typedef struct Distance_Cache Distance_Cache;
+
+typedef struct Ray Ray;
+
+typedef struct Ray_Hit Ray_Hit;
+
+typedef struct Ray_Packet Ray_Packet;
+
+typedef struct Ray_Packet_Hit Ray_Packet_Hit;
+
 enum Shape_Type
 {
 	SHAPE_TYPE_SEGMENT,
@@ -55,6 +73,21 @@ struct Transform
 	double c;
 };
 
+struct Matrix
+{
+	double xx;
+
+	double xy;
+
+	double yx;
+
+	double yy;
+
+	double x;
+
+	double y;
+};
+
 struct Segment
 {
 	Vector a;
@@ -106,6 +139,49 @@ struct Collision
 	double depth;
 };
 
+struct Distance_Cache
+{
+	int count;
+
+	int indices_1[3];
+
+	int indices_2[3];
+};
+
+struct Ray
+{
+	Vector origin;
+
+	Vector direction;
+};
+
+struct Ray_Hit
+{
+	double fraction;
+
+	Vector normal;
+};
+
+struct Ray_Packet
+{
+	double origin_x[RAY_PACKET_SIZE];
+
+	double origin_y[RAY_PACKET_SIZE];
+
+	double direction_x[RAY_PACKET_SIZE];
+
+	double direction_y[RAY_PACKET_SIZE];
+};
+
+struct Ray_Packet_Hit
+{
+	double fraction[RAY_PACKET_SIZE];
+
+	double normal_x[RAY_PACKET_SIZE];
+
+	double normal_y[RAY_PACKET_SIZE];
+};
+
 Vector vector_create(double x, double y);
 
 bool vector_equal(Vector v, Vector w);
@@ -160,6 +236,22 @@ Transform transform_invert(Transform transform);
 
 Vector transform_apply(Transform transform, Vector vector);
 
+Matrix matrix_create_identity();
+
+Matrix matrix_create_ortho(const Rect* from, const Rect* to);
+
+Matrix matrix_multiply(Matrix matrix_1, Matrix matrix_2);
+
+Matrix matrix_translate(Matrix matrix, Vector translation);
+
+Matrix matrix_rotate(Matrix matrix, double angle);
+
+Matrix matrix_scale(Matrix matrix, Vector factor);
+
+Matrix matrix_invert(Matrix matrix);
+
+Vector matrix_apply(Matrix matrix, Vector vector);
+
 Vector segment_get_centroid(const Segment* segment);
 
 double segment_get_linear_mass_factor(const Segment* segment);
@@ -168,6 +260,8 @@ double segment_get_angular_mass_factor(const Segment* segment);
 
 Rect segment_get_bounding_rect(const Segment* segment);
 
+double segment_get_bounding_radius(const Segment* segment, Vector center);
+
 void segment_transform(const Segment* segment, Transform transform, Segment* result);
 
 bool segment_test_point(const Segment* segment, Vector point);
@@ -180,6 +274,8 @@ double circle_get_angular_mass_factor(const Circle* circle);
 
 Rect circle_get_bounding_rect(const Circle* circle);
 
+double circle_get_bounding_radius(const Circle* circle, Vector center);
+
 void circle_transform(const Circle* circle, Transform transform, Circle* result);
 
 bool circle_test_point(const Circle* circle, Vector point);
@@ -192,6 +288,8 @@ double polygon_get_angular_mass_factor(const Polygon* polygon);
 
 Rect polygon_get_bounding_rect(const Polygon* polygon);
 
+double polygon_get_bounding_radius(const Polygon* polygon, Vector center);
+
 void polygon_transform(const Polygon* polygon, Transform transform, Polygon* result);
 
 bool polygon_test_point(const Polygon* polygon, Vector point);
@@ -202,6 +300,10 @@ Shape* shape_create_circle(Vector center, double radius);
 
 Shape* shape_create_polygon(int point_count, const Vector points[]);
 
+Shape* shape_create_convex_hull(int point_count, const Vector points[]);
+
+Shape** shape_create_convex_decomposition(int point_count, const Vector points[], double weld_distance, int* shape_count);
+
 Shape* shape_clone_segment(const Segment* segment);
 
 Shape* shape_clone_circle(const Circle* circle);
@@ -212,6 +314,8 @@ Shape* shape_clone(const Shape* shape);
 
 void shape_destroy(Shape* shape);
 
+size_t shape_get_size(const Shape* shape);
+
 Vector shape_get_centroid(const Shape* shape);
 
 double shape_get_linear_mass_factor(const Shape* shape);
@@ -220,6 +324,8 @@ double shape_get_angular_mass_factor(const Shape* shape);
 
 Rect shape_get_bounding_rect(const Shape* shape);
 
+double shape_get_bounding_radius(const Shape* shape, Vector center);
+
 void shape_transform(const Shape* shape, Transform transform, Shape* result);
 
 bool shape_test_point(const Shape* shape, Vector point);
@@ -228,8 +334,70 @@ Vector project_onto_line(Vector a, Vector b, Vector p);
 
 Vector project_onto_segment(Vector a, Vector b, Vector p);
 
+Rect rect_merge(const Rect* rect_1, const Rect* rect_2);
+
+Vector rect_get_center(const Rect* rect);
+
+Rect rect_transform(const Rect* rect, Transform transform);
+
 bool test_point_rect(Vector point, const Rect* rect);
 
+bool test_point_triangle(Vector point, Vector a, Vector b, Vector c);
+
+int compute_convex_hull(int point_count, const Vector points[], Vector hull[]);
+
+int weld_points(int point_count, const Vector points[], double weld_distance, Vector result[]);
+
+bool test_rect_rect(const Rect* rect_1, const Rect* rect_2);
+
+bool test_ray_rect(const Ray* ray, double fraction, const Rect* rect);
+
+bool test_shape_distance(const Shape* shape_1, const Shape* shape_2, double distance);
+
+double shape_distance(const Shape* shape_1, const Shape* shape_2, Vector* closest_1, Vector* closest_2);
+
+double shape_distance_cached(const Shape* shape_1, const Shape* shape_2, Distance_Cache* cache, Vector* closest_1, Vector* closest_2);
+
+void shape_distances(int pair_count, const Shape* const shapes_1[], const Shape* const shapes_2[], Distance_Cache caches[], double distances[], Vector closests_1[], Vector closests_2[]);
+
+Rect ray_packet_get_bounding_rect(const Ray_Packet* packet, const Ray_Packet_Hit* hit);
+
+bool raycast_shape(const Shape* shape, const Ray* ray, Ray_Hit* hit);
+
+bool raycast_segment(const Segment* segment, const Ray* ray, Ray_Hit* hit);
+
+bool raycast_circle(const Circle* circle, const Ray* ray, Ray_Hit* hit);
+
+bool raycast_polygon(const Polygon* polygon, const Ray* ray, Ray_Hit* hit);
+
+void raycast_shape_packet(const Shape* shape, const Ray_Packet* packet, Ray_Packet_Hit* hit);
+
+void raycast_segment_packet(const Segment* segment, const Ray_Packet* packet, Ray_Packet_Hit* hit);
+
+void raycast_circle_packet(const Circle* circle, const Ray_Packet* packet, Ray_Packet_Hit* hit);
+
+void raycast_polygon_packet(const Polygon* polygon, const Ray_Packet* packet, Ray_Packet_Hit* hit);
+
+bool overlap_shapes(const Shape* shape_1, const Shape* shape_2);
+
+bool overlap_segments(const Segment* segment_1, const Segment* segment_2);
+
+bool overlap_circles(const Circle* circle_1, const Circle* circle_2);
+
+bool overlap_polygons(const Polygon* polygon_1, const Polygon* polygon_2);
+
+bool overlap_segment_circle(const Segment* segment, const Circle* circle);
+
+bool overlap_segment_polygon(const Segment* segment, const Polygon* polygon);
+
+bool overlap_circle_polygon(const Circle* circle, const Polygon* polygon);
+
+bool overlap_circle_segment(const Circle* circle, const Segment* segment);
+
+bool overlap_polygon_segment(const Polygon* polygon, const Segment* segment);
+
+bool overlap_polygon_circle(const Polygon* polygon, const Circle* circle);
+
 bool collide_shapes(const Shape* shape_1, const Shape* shape_2, Collision* collision);
 
 bool collide_segments(const Segment* segment_1, const Segment* segment_2, Collision* collision);
@@ -1,12 +1,422 @@
 #include "graphics.h"
 
+#include "graphics_software.h"
+
+#include "file.h"
+
+#include "image.h"
+
+#include "time.h"
+
+#include <limits.h>
+
+#include <stdarg.h>
+
+#ifdef _WIN32
+
 #include "platform.h"
 
-static Texture* s_texture;
+#endif
 
-static Texture* s_font;
+typedef struct Image_Atlas_Node Image_Atlas_Node;
 
-Image* image_load(const char* path)
+typedef struct Image_Atlas_Item Image_Atlas_Item;
+
+typedef struct Graphics_Text_Run Graphics_Text_Run;
+
+struct Image_Atlas_Node
+{
+	int x;
+
+	int y;
+
+	int width;
+};
+
+struct Image_Atlas_Item
+{
+	int index;
+
+	int width;
+
+	int height;
+};
+
+struct Graphics_Text_Run
+{
+	const Texture* font;
+
+	bool format;
+
+	char* key;
+
+	char* text;
+
+	int length;
+
+	int capacity;
+
+	Graphics_Vertex* vertices;
+
+	unsigned int last_use;
+};
+
+static const Graphics_Backend* s_backend;
+
+static Graphics_Command_Buffer s_buffer;
+
+static Graphics_Vertex* s_sorted_vertices;
+
+static Graphics_Statistics s_statistics;
+
+static const Texture* s_texture;
+
+static const Texture* s_font;
+
+static Rect s_camera = { { -1.0, -1.0 }, { 1.0, 1.0 } };
+
+static unsigned int s_color = 0xFFFFFFFF;
+
+static Vector s_viewport_size;
+
+static Matrix s_viewport_transform;
+
+static bool s_viewport_transform_is_dirty = true;
+
+static Matrix s_transform = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
+
+static Matrix* s_transforms;
+
+static int s_transform_count;
+
+static int s_transform_capacity;
+
+static Matrix s_inverse_transform = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
+
+static bool s_inverse_transform_is_dirty;
+
+static Rect s_visible_rect;
+
+static bool s_visible_rect_is_dirty = true;
+
+static bool s_batch_sorting;
+
+static Graphics_Text_Run s_text_runs[GRAPHICS_TEXT_CACHE_SIZE];
+
+static unsigned int s_text_use;
+
+static char* s_text;
+
+static int s_text_capacity;
+
+static Texture_Request* s_first_texture_request;
+
+static Texture_Request* s_last_texture_request;
+
+static Vector s_circle_points[GRAPHICS_CIRCLE_VERTEX_COUNT_MIN * ((1 << GRAPHICS_CIRCLE_LOD_COUNT) - 1)];
+
+static double s_circle_radii[GRAPHICS_CIRCLE_LOD_COUNT];
+
+static bool s_circle_points_are_ready;
+
+static void graphics_forget_text_runs(const Texture* font)
+{
+	for (int i = 0; i < GRAPHICS_TEXT_CACHE_SIZE; i++)
+	{
+		if (s_text_runs[i].font == font)
+		{
+			free(s_text_runs[i].key);
+
+			s_text_runs[i].key = NULL;
+
+			s_text_runs[i].font = NULL;
+		}
+	}
+}
+
+static int graphics_draw_command_compare(const void* command_1, const void* command_2)
+{
+	const Graphics_Command* c_1 = command_1;
+
+	const Graphics_Command* c_2 = command_2;
+
+	if (c_1->primitive != c_2->primitive)
+	{
+		return (c_1->primitive > c_2->primitive) - (c_1->primitive < c_2->primitive);
+	}
+
+	if (c_1->texture_id != c_2->texture_id)
+	{
+		return (c_1->texture_id > c_2->texture_id) - (c_1->texture_id < c_2->texture_id);
+	}
+
+	return (c_1->sequence > c_2->sequence) - (c_1->sequence < c_2->sequence);
+}
+
+static int image_atlas_item_compare(const void* item_1, const void* item_2)
+{
+	const Image_Atlas_Item* i_1 = item_1;
+
+	const Image_Atlas_Item* i_2 = item_2;
+
+	if (i_1->height != i_2->height)
+	{
+		return (i_1->height < i_2->height) - (i_1->height > i_2->height);
+	}
+
+	if (i_1->width != i_2->width)
+	{
+		return (i_1->width < i_2->width) - (i_1->width > i_2->width);
+	}
+
+	return (i_1->index > i_2->index) - (i_1->index < i_2->index);
+}
+
+static int image_atlas_fit(const Image_Atlas_Node nodes[], int node_index, int width, int height, int page_size)
+{
+	if (nodes[node_index].x + width > page_size)
+	{
+		return -1;
+	}
+
+	int y = 0;
+
+	for (int i = node_index, remaining_width = width; remaining_width > 0; i++)
+	{
+		y = imax(y, nodes[i].y);
+
+		remaining_width -= nodes[i].width;
+	}
+
+	return y + height <= page_size ? y : -1;
+}
+
+static int image_atlas_insert(Image_Atlas_Node nodes[], int node_count, int node_index, int y, int width, int height)
+{
+	memmove(&nodes[node_index + 1], &nodes[node_index], (node_count - node_index) * sizeof(Image_Atlas_Node));
+
+	nodes[node_index].y = y + height;
+
+	nodes[node_index].width = width;
+
+	node_count++;
+
+	for (int i = node_index + 1; i < node_count; )
+	{
+		int overlap = nodes[i - 1].x + nodes[i - 1].width - nodes[i].x;
+
+		if (overlap <= 0)
+		{
+			break;
+		}
+
+		nodes[i].x += overlap;
+
+		nodes[i].width -= overlap;
+
+		if (nodes[i].width > 0)
+		{
+			break;
+		}
+
+		memmove(&nodes[i], &nodes[i + 1], (node_count - i - 1) * sizeof(Image_Atlas_Node));
+
+		node_count--;
+	}
+
+	for (int i = 0; i + 1 < node_count; )
+	{
+		if (nodes[i].y != nodes[i + 1].y)
+		{
+			i++;
+
+			continue;
+		}
+
+		nodes[i].width += nodes[i + 1].width;
+
+		memmove(&nodes[i + 1], &nodes[i + 2], (node_count - i - 2) * sizeof(Image_Atlas_Node));
+
+		node_count--;
+	}
+
+	return node_count;
+}
+
+static void image_atlas_copy(Image* page, const Image* image, int x, int y, int padding, bool extrude)
+{
+	unsigned int* page_pixels = page->pixels;
+
+	const unsigned int* image_pixels = image->pixels;
+
+	for (int i = -padding; i < image->height + padding; i++)
+	{
+		for (int j = -padding; j < image->width + padding; j++)
+		{
+			bool inside = i >= 0 && j >= 0 && i < image->height && j < image->width;
+
+			if (!inside && !extrude)
+			{
+				continue;
+			}
+
+			int source_x = imin(imax(j, 0), image->width - 1);
+
+			int source_y = imin(imax(i, 0), image->height - 1);
+
+			page_pixels[(y + i) * page->width + x + j] = image_pixels[source_y * image->width + source_x];
+		}
+	}
+}
+
+static Graphics_Command* graphics_add_command(Graphics_Command_Type type)
+{
+	if (s_buffer.command_count == s_buffer.command_capacity)
+	{
+		s_buffer.command_capacity = imax(s_buffer.command_capacity * 2, 64);
+
+		s_buffer.commands = realloc(s_buffer.commands, s_buffer.command_capacity * sizeof(Graphics_Command));
+	}
+
+	Graphics_Command* command = &s_buffer.commands[s_buffer.command_count++];
+
+	command->type = type;
+
+	return command;
+}
+
+static Graphics_Vertex* graphics_add_vertices(Graphics_Primitive primitive, int vertex_count)
+{
+	if (s_buffer.vertex_count + vertex_count > s_buffer.vertex_capacity)
+	{
+		s_buffer.vertex_capacity = imax(s_buffer.vertex_capacity * 2, imax(s_buffer.vertex_count + vertex_count, 1024));
+
+		s_buffer.vertices = realloc(s_buffer.vertices, s_buffer.vertex_capacity * sizeof(Graphics_Vertex));
+	}
+
+	int texture_id = s_texture != NULL ? s_texture->id : 0;
+
+	Graphics_Command* command = s_buffer.command_count > 0 ? &s_buffer.commands[s_buffer.command_count - 1] : NULL;
+
+	if (command == NULL || command->type != GRAPHICS_COMMAND_TYPE_DRAW || command->primitive != primitive || command->texture_id != texture_id)
+	{
+		command = graphics_add_command(GRAPHICS_COMMAND_TYPE_DRAW);
+
+		command->primitive = primitive;
+
+		command->texture_id = texture_id;
+
+		command->premultiplied = s_texture != NULL && s_texture->premultiplied;
+
+		command->first = s_buffer.vertex_count;
+
+		command->count = 0;
+
+		command->sequence = s_buffer.command_count;
+	}
+
+	Graphics_Vertex* vertices = s_buffer.vertices + s_buffer.vertex_count;
+
+	command->count += vertex_count;
+
+	s_buffer.vertex_count += vertex_count;
+
+	return vertices;
+}
+
+static void graphics_sort_draw_commands()
+{
+	s_sorted_vertices = realloc(s_sorted_vertices, s_buffer.vertex_capacity * sizeof(Graphics_Vertex));
+
+	int command_count = 0;
+
+	int vertex_count = 0;
+
+	for (int i = 0; i < s_buffer.command_count; )
+	{
+		if (s_buffer.commands[i].type != GRAPHICS_COMMAND_TYPE_DRAW)
+		{
+			s_buffer.commands[command_count++] = s_buffer.commands[i++];
+
+			continue;
+		}
+
+		int j = i;
+
+		while (j < s_buffer.command_count && s_buffer.commands[j].type == GRAPHICS_COMMAND_TYPE_DRAW)
+		{
+			j++;
+		}
+
+		qsort(s_buffer.commands + i, j - i, sizeof(Graphics_Command), graphics_draw_command_compare);
+
+		for (; i < j; i++)
+		{
+			Graphics_Command command = s_buffer.commands[i];
+
+			memcpy(s_sorted_vertices + vertex_count, s_buffer.vertices + command.first, command.count * sizeof(Graphics_Vertex));
+
+			command.first = vertex_count;
+
+			vertex_count += command.count;
+
+			Graphics_Command* previous = command_count > 0 ? &s_buffer.commands[command_count - 1] : NULL;
+
+			if (previous != NULL && previous->type == GRAPHICS_COMMAND_TYPE_DRAW && previous->primitive == command.primitive && previous->texture_id == command.texture_id)
+			{
+				previous->count += command.count;
+			}
+			else
+			{
+				s_buffer.commands[command_count++] = command;
+			}
+		}
+	}
+
+	s_buffer.command_count = command_count;
+
+	Graphics_Vertex* vertices = s_buffer.vertices;
+
+	s_buffer.vertices = s_sorted_vertices;
+
+	s_sorted_vertices = vertices;
+}
+
+static void graphics_update_statistics()
+{
+	int texture_id = -1;
+
+	s_statistics.flush_count++;
+
+	s_statistics.command_count += s_buffer.command_count;
+
+	s_statistics.vertex_count += s_buffer.vertex_count;
+
+	for (int i = 0; i < s_buffer.command_count; i++)
+	{
+		const Graphics_Command* command = &s_buffer.commands[i];
+
+		if (command->type != GRAPHICS_COMMAND_TYPE_DRAW)
+		{
+			s_statistics.state_change_count++;
+
+			continue;
+		}
+
+		s_statistics.draw_count++;
+
+		if (command->texture_id != texture_id)
+		{
+			s_statistics.texture_change_count++;
+
+			texture_id = command->texture_id;
+		}
+	}
+}
+
+#ifdef _WIN32
+
+static Image* image_load_wic(const char* path)
 {
 	wchar_t wide_path[MAX_PATH];
 
@@ -20,7 +430,14 @@ Image* image_load(const char* path)
 
 	IWICBitmapDecoder* decoder;
 
-	factory->lpVtbl->CreateDecoderFromFilename(factory, wide_path, NULL, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder);
+	if (FAILED(factory->lpVtbl->CreateDecoderFromFilename(factory, wide_path, NULL, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder)))
+	{
+		factory->lpVtbl->Release(factory);
+
+		CoUninitialize();
+
+		return NULL;
+	}
 
 	IWICBitmapFrameDecode* frame;
 
@@ -40,25 +457,13 @@ Image* image_load(const char* path)
 
 	char* pixels = malloc(row_size * height);
 
-	bitmap->lpVtbl->CopyPixels(bitmap, NULL, row_size, row_size * height, pixels);
-
-	char* temp = malloc(row_size);
-
-	for (int i = 0; i * 2 < height; i++)
+	for (int i = 0; i < height; i++)
 	{
-		char* top_row = pixels + i * row_size;
-
-		char* bottom_row = pixels + (height - 1 - i) * row_size;
-
-		memcpy(temp, top_row, row_size);
+		WICRect rect = { 0, i, width, 1 };
 
-		memcpy(top_row, bottom_row, row_size);
-
-		memcpy(bottom_row, temp, row_size);
+		bitmap->lpVtbl->CopyPixels(bitmap, &rect, row_size, row_size, pixels + (height - 1 - i) * row_size);
 	}
 
-	free(temp);
-
 	Image* image = malloc(sizeof(Image));
 
 	image->width = width;
@@ -80,147 +485,1624 @@ Image* image_load(const char* path)
 	return image;
 }
 
-void image_destroy(Image* image)
+#endif
+
+static Image* image_decode_file(const char* path, const File_Mapping* mapping)
 {
-	free(image->pixels);
+	Image* image = mapping->size > 0 && mapping->size <= INT_MAX ? image_decode(mapping->data, (int)mapping->size) : NULL;
 
-	free(image);
+#ifdef _WIN32
+
+	if (image == NULL)
+	{
+		image = image_load_wic(path);
+	}
+
+#endif
+
+	return image;
 }
 
-Texture* texture_create_from_file(const char* path)
+static void image_load_task(void* data, int index)
 {
-	Image* image = image_load(path);
-
-	Texture* texture = texture_create_from_image(image);
+	Image_Request* request = data;
 
-	image_destroy(image);
+	request->image = image_load(request->path);
+}
 
-	return texture;
+static size_t texture_file_get_level_size(int width, int height)
+{
+	return ((size_t)width * height * 4 + TEXTURE_FILE_ALIGNMENT - 1) / TEXTURE_FILE_ALIGNMENT * TEXTURE_FILE_ALIGNMENT;
 }
 
-Texture* texture_create_from_image(const Image* image)
+static bool texture_file_get_levels(const unsigned char* data, size_t size, Image levels[TEXTURE_FILE_LEVEL_COUNT_MAX])
 {
-	Texture* texture = malloc(sizeof(Texture));
+	const Texture_File_Header* header = (const Texture_File_Header*)data;
 
-	texture->size = vector_create(image->width, image->height);
+	if (size < sizeof(Texture_File_Header) || header->magic != TEXTURE_FILE_MAGIC)
+	{
+		return false;
+	}
 
-	texture->center = vector_create(image->width / 2.0, image->height / 2.0);
+	if (header->width <= 0 || header->height <= 0 || header->width > IMAGE_SIZE_MAX || header->height > IMAGE_SIZE_MAX || header->level_count < 1 || header->level_count > TEXTURE_FILE_LEVEL_COUNT_MAX)
+	{
+		return false;
+	}
+
+	if (header->data_offset < (int)sizeof(Texture_File_Header) || header->data_offset % TEXTURE_FILE_ALIGNMENT != 0)
+	{
+		return false;
+	}
+
+	size_t offset = header->data_offset;
+
+	int width = header->width;
+
+	int height = header->height;
+
+	for (int i = 0; i < header->level_count; i++)
+	{
+		levels[i].width = width;
+
+		levels[i].height = height;
+
+		levels[i].pixels = (void*)(data + offset);
+
+		offset += texture_file_get_level_size(width, height);
+
+		width = imax(width / 2, 1);
+
+		height = imax(height / 2, 1);
+	}
+
+	return offset <= size;
+}
+
+static Texture* texture_create_from_texture_file(const unsigned char* data, size_t size)
+{
+	Image levels[TEXTURE_FILE_LEVEL_COUNT_MAX];
+
+	if (!texture_file_get_levels(data, size, levels))
+	{
+		return NULL;
+	}
+
+	const Texture_File_Header* header = (const Texture_File_Header*)data;
+
+	Texture* texture = malloc(sizeof(Texture));
+
+	texture->size = header->size;
+
+	texture->center = header->center;
 
 	texture->scale = vector_create(1.0, 1.0);
 
-	glGenTextures(1, &texture->id);
+	texture->rect = (Rect){ { 0.0, 0.0 }, { 1.0, 1.0 } };
+
+	texture->premultiplied = (header->flags & TEXTURE_FILE_FLAG_PREMULTIPLIED) != 0;
+
+	graphics_get_backend()->create_texture(texture, header->level_count, levels);
+
+	return texture;
+}
+
+static void texture_load_task(void* data, int index)
+{
+	Texture_Request* request = data;
+
+	File_Mapping* mapping = file_mapping_create(request->path);
+
+	if (mapping == NULL)
+	{
+		return;
+	}
+
+	Image levels[TEXTURE_FILE_LEVEL_COUNT_MAX];
+
+	if (texture_file_get_levels(mapping->data, mapping->size, levels))
+	{
+		file_mapping_prefetch(mapping);
+
+		request->mapping = mapping;
+	}
+	else
+	{
+		request->image = image_decode_file(request->path, mapping);
+
+		file_mapping_destroy(mapping);
+	}
+}
+
+static void texture_request_finish(Texture_Request* request)
+{
+	Texture_Request* prev = NULL;
+
+	for (Texture_Request* other = s_first_texture_request; other != request; other = other->next)
+	{
+		prev = other;
+	}
+
+	if (prev == NULL)
+	{
+		s_first_texture_request = request->next;
+	}
+	else
+	{
+		prev->next = request->next;
+	}
+
+	if (s_last_texture_request == request)
+	{
+		s_last_texture_request = prev;
+	}
+
+	thread_job_wait(request->job);
+
+	if (request->mapping != NULL)
+	{
+		request->texture = texture_create_from_texture_file(request->mapping->data, request->mapping->size);
+
+		file_mapping_destroy(request->mapping);
+	}
+	else if (request->image != NULL)
+	{
+		request->texture = texture_create_from_image(request->image);
+
+		image_destroy(request->image);
+	}
+
+	free(request->path);
+
+	request->path = NULL;
+
+	request->mapping = NULL;
+
+	request->image = NULL;
+
+	request->job = NULL;
+
+	request->is_done = true;
+}
+
+static void image_premultiply(Image* image)
+{
+	unsigned char* pixels = image->pixels;
+
+	for (int i = 0; i < image->width * image->height * 4; i += 4)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			pixels[i + j] = (pixels[i + j] * pixels[i + 3] + 127) / 255;
+		}
+	}
+}
+
+static Image* image_downsample(const Image* image)
+{
+	Image* result = malloc(sizeof(Image));
+
+	result->width = imax(image->width / 2, 1);
+
+	result->height = imax(image->height / 2, 1);
+
+	result->pixels = malloc(result->width * result->height * 4);
+
+	const unsigned char* source = image->pixels;
+
+	unsigned char* destination = result->pixels;
+
+	for (int y = 0; y < result->height; y++)
+	{
+		int y_1 = imin(y * 2, image->height - 1);
+
+		int y_2 = imin(y * 2 + 1, image->height - 1);
+
+		for (int x = 0; x < result->width; x++)
+		{
+			int x_1 = imin(x * 2, image->width - 1);
+
+			int x_2 = imin(x * 2 + 1, image->width - 1);
+
+			for (int i = 0; i < 4; i++)
+			{
+				int sum = source[(y_1 * image->width + x_1) * 4 + i] + source[(y_1 * image->width + x_2) * 4 + i] + source[(y_2 * image->width + x_1) * 4 + i] + source[(y_2 * image->width + x_2) * 4 + i];
+
+				destination[(y * result->width + x) * 4 + i] = (sum + 2) / 4;
+			}
+		}
+	}
+
+	return result;
+}
+
+static int graphics_sprite_compare(const void* sprite_1, const void* sprite_2)
+{
+	int s_1 = *(const int*)sprite_1;
+
+	int s_2 = *(const int*)sprite_2;
+
+	return (s_1 > s_2) - (s_1 < s_2);
+}
+
+static Rect graphics_get_points_bounding_rect(int point_count, const Vector points[])
+{
+	Rect rect = { { INFINITY, INFINITY }, { -INFINITY, -INFINITY } };
+
+	for (int i = 0; i < point_count; i++)
+	{
+		rect.min.x = fmin(rect.min.x, points[i].x);
+
+		rect.min.y = fmin(rect.min.y, points[i].y);
+
+		rect.max.x = fmax(rect.max.x, points[i].x);
+
+		rect.max.y = fmax(rect.max.y, points[i].y);
+	}
+
+	return rect;
+}
+
+static bool graphics_is_visible(const Rect* rect)
+{
+	Rect visible_rect = graphics_get_visible_rect();
+
+	return test_rect_rect(rect, &visible_rect);
+}
+
+static int graphics_sprite_layer_get_cell(const Graphics_Sprite_Layer* layer, double coordinate, double origin, int cell_count)
+{
+	return imin(imax(floor((coordinate - origin) / layer->cell_size), 0), cell_count - 1);
+}
+
+static void graphics_sprite_layer_build_grid(Graphics_Sprite_Layer* layer)
+{
+	layer->bounding_rect = (Rect){ { INFINITY, INFINITY }, { -INFINITY, -INFINITY } };
+
+	for (int i = 0; i < layer->sprite_count; i++)
+	{
+		layer->bounding_rect = rect_merge(&layer->bounding_rect, &layer->sprites[i].rect);
+	}
+
+	layer->cell_count_x = imax(ceil((layer->bounding_rect.max.x - layer->bounding_rect.min.x) / layer->cell_size), 1);
+
+	layer->cell_count_y = imax(ceil((layer->bounding_rect.max.y - layer->bounding_rect.min.y) / layer->cell_size), 1);
+
+	int cell_count = layer->cell_count_x * layer->cell_count_y;
+
+	layer->cell_starts = realloc(layer->cell_starts, (cell_count + 1) * sizeof(int));
+
+	memset(layer->cell_starts, 0, (cell_count + 1) * sizeof(int));
+
+	int entry_count = 0;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = layer->sprite_count - 1; i >= 0; i--)
+		{
+			const Rect* rect = &layer->sprites[i].rect;
+
+			int min_x = graphics_sprite_layer_get_cell(layer, rect->min.x, layer->bounding_rect.min.x, layer->cell_count_x);
+
+			int min_y = graphics_sprite_layer_get_cell(layer, rect->min.y, layer->bounding_rect.min.y, layer->cell_count_y);
+
+			int max_x = graphics_sprite_layer_get_cell(layer, rect->max.x, layer->bounding_rect.min.x, layer->cell_count_x);
+
+			int max_y = graphics_sprite_layer_get_cell(layer, rect->max.y, layer->bounding_rect.min.y, layer->cell_count_y);
+
+			for (int cell_y = min_y; cell_y <= max_y; cell_y++)
+			{
+				for (int cell_x = min_x; cell_x <= max_x; cell_x++)
+				{
+					int cell = cell_y * layer->cell_count_x + cell_x;
+
+					if (pass == 0)
+					{
+						layer->cell_starts[cell]++;
+
+						entry_count++;
+					}
+					else
+					{
+						layer->cell_sprites[--layer->cell_starts[cell]] = i;
+					}
+				}
+			}
+		}
+
+		if (pass == 0)
+		{
+			for (int cell = 1; cell <= cell_count; cell++)
+			{
+				layer->cell_starts[cell] += layer->cell_starts[cell - 1];
+			}
+
+			layer->cell_sprites = realloc(layer->cell_sprites, imax(entry_count, 1) * sizeof(int));
+		}
+	}
+
+	layer->visible_sprites = realloc(layer->visible_sprites, imax(layer->sprite_count, 1) * sizeof(int));
+
+	layer->grid_is_dirty = false;
+}
+
+static unsigned int graphics_get_vertex_color(unsigned int color)
+{
+	unsigned char channels[4];
+
+	if (color == 0xFFFFFFFF || s_color == 0xFFFFFFFF)
+	{
+		color &= s_color;
+	}
+	else
+	{
+		unsigned char color_channels[4];
+
+		memcpy(channels, &color, sizeof(channels));
+
+		memcpy(color_channels, &s_color, sizeof(color_channels));
+
+		for (int i = 0; i < 4; i++)
+		{
+			channels[i] = (channels[i] * color_channels[i] + 127) / 255;
+		}
+
+		memcpy(&color, channels, sizeof(color));
+	}
+
+	if (s_texture == NULL || !s_texture->premultiplied || color == 0xFFFFFFFF)
+	{
+		return color;
+	}
+
+	memcpy(channels, &color, sizeof(channels));
+
+	for (int i = 0; i < 3; i++)
+	{
+		channels[i] = (channels[i] * channels[3] + 127) / 255;
+	}
+
+	memcpy(&color, channels, sizeof(color));
+
+	return color;
+}
+
+static void graphics_set_transform(Matrix transform)
+{
+	s_transform = transform;
 
-	glBindTexture(GL_TEXTURE_2D, texture->id);
+	s_inverse_transform_is_dirty = true;
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image->width, image->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image->pixels);
+	s_visible_rect_is_dirty = true;
+}
+
+static void graphics_set_vertex(Graphics_Vertex* vertex, Vector position, Vector texture_position)
+{
+	position = matrix_apply(s_transform, position);
+
+	vertex->x = position.x;
+
+	vertex->y = position.y;
+
+	if (s_texture != NULL)
+	{
+		texture_position.x = s_texture->rect.min.x + (s_texture->rect.max.x - s_texture->rect.min.x) * texture_position.x;
+
+		texture_position.y = s_texture->rect.min.y + (s_texture->rect.max.y - s_texture->rect.min.y) * texture_position.y;
+	}
+
+	vertex->u = texture_position.x;
+
+	vertex->v = texture_position.y;
+
+	vertex->color = graphics_get_vertex_color(0xFFFFFFFF);
+}
+
+static void graphics_add_polygon(int point_count, const Vector points[], bool fill)
+{
+	if (point_count < 3)
+	{
+		return;
+	}
+
+	Rect bounding_rect = graphics_get_points_bounding_rect(point_count, points);
+
+	if (!graphics_is_visible(&bounding_rect))
+	{
+		return;
+	}
+
+	if (fill)
+	{
+		Graphics_Vertex* vertices = graphics_add_vertices(GRAPHICS_PRIMITIVE_TRIANGLES, (point_count - 2) * 3);
+
+		for (int i = 2; i < point_count; i++)
+		{
+			graphics_set_vertex(vertices++, points[0], vector_create(0.0, 0.0));
+
+			graphics_set_vertex(vertices++, points[i - 1], vector_create(0.0, 0.0));
+
+			graphics_set_vertex(vertices++, points[i], vector_create(0.0, 0.0));
+		}
+	}
+	else
+	{
+		Graphics_Vertex* vertices = graphics_add_vertices(GRAPHICS_PRIMITIVE_LINES, point_count * 2);
+
+		for (int i = point_count - 1, j = 0; j < point_count; i = j, j++)
+		{
+			graphics_set_vertex(vertices++, points[i], vector_create(0.0, 0.0));
+
+			graphics_set_vertex(vertices++, points[j], vector_create(0.0, 0.0));
+		}
+	}
+}
+
+Image* image_load(const char* path)
+{
+	File_Mapping* mapping = file_mapping_create(path);
+
+	if (mapping == NULL)
+	{
+		return NULL;
+	}
+
+	Image* image = image_decode_file(path, mapping);
+
+	file_mapping_destroy(mapping);
+
+	return image;
+}
+
+Image* image_load_from_pack(const File_Pack* pack, const char* name)
+{
+	size_t size;
+
+	const unsigned char* data = file_pack_find(pack, name, &size);
+
+	return data != NULL && size > 0 && size <= INT_MAX ? image_decode(data, (int)size) : NULL;
+}
+
+Image_Request* image_load_async(const char* path)
+{
+	Image_Request* request = malloc(sizeof(Image_Request));
+
+	request->path = malloc(strlen(path) + 1);
+
+	strcpy(request->path, path);
+
+	request->image = NULL;
 
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	request->job = thread_job_submit(image_load_task, request, 1);
 
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	return request;
+}
 
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+bool image_request_is_done(const Image_Request* request)
+{
+	return thread_job_is_done(request->job);
+}
 
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+Image* image_request_wait(Image_Request* request)
+{
+	thread_job_wait(request->job);
+
+	Image* image = request->image;
+
+	free(request->path);
+
+	free(request);
+
+	return image;
+}
+
+void image_destroy(Image* image)
+{
+	free(image->pixels);
+
+	free(image);
+}
+
+Image_Atlas* image_atlas_create(int image_count, const Image* const images[], int page_size, int padding, bool extrude)
+{
+	Image_Atlas_Item* items = malloc(image_count * sizeof(Image_Atlas_Item));
+
+	for (int i = 0; i < image_count; i++)
+	{
+		items[i].index = i;
+
+		items[i].width = images[i]->width + padding * 2;
+
+		items[i].height = images[i]->height + padding * 2;
+
+		if (items[i].width > page_size || items[i].height > page_size)
+		{
+			free(items);
+
+			return NULL;
+		}
+	}
+
+	qsort(items, image_count, sizeof(Image_Atlas_Item), image_atlas_item_compare);
+
+	Image_Atlas* atlas = malloc(sizeof(Image_Atlas));
+
+	atlas->page_size = page_size;
+
+	atlas->page_count = 0;
+
+	atlas->pages = NULL;
+
+	atlas->entry_count = image_count;
+
+	atlas->entries = malloc(image_count * sizeof(Image_Atlas_Entry));
+
+	Image_Atlas_Node** page_nodes = NULL;
+
+	int* page_node_counts = NULL;
+
+	for (int i = 0; i < image_count; i++)
+	{
+		const Image_Atlas_Item* item = &items[i];
+
+		int best_page = -1;
+
+		int best_node = -1;
+
+		int best_x = 0;
+
+		int best_y = 0;
+
+		for (int page = 0; page < atlas->page_count; page++)
+		{
+			for (int node = 0; node < page_node_counts[page]; node++)
+			{
+				int y = image_atlas_fit(page_nodes[page], node, item->width, item->height, page_size);
+
+				int x = page_nodes[page][node].x;
+
+				if (y >= 0 && (best_page == -1 || y < best_y || (y == best_y && x < best_x)))
+				{
+					best_page = page;
+
+					best_node = node;
+
+					best_x = x;
+
+					best_y = y;
+				}
+			}
+
+			if (best_page != -1)
+			{
+				break;
+			}
+		}
+
+		if (best_page == -1)
+		{
+			best_page = atlas->page_count++;
+
+			best_node = 0;
+
+			best_x = 0;
+
+			best_y = 0;
+
+			atlas->pages = realloc(atlas->pages, atlas->page_count * sizeof(Image*));
+
+			page_nodes = realloc(page_nodes, atlas->page_count * sizeof(Image_Atlas_Node*));
+
+			page_node_counts = realloc(page_node_counts, atlas->page_count * sizeof(int));
+
+			Image* page = malloc(sizeof(Image));
+
+			page->width = page_size;
+
+			page->height = page_size;
+
+			page->pixels = calloc(page_size * page_size, 4);
+
+			atlas->pages[best_page] = page;
+
+			page_nodes[best_page] = malloc((page_size + 1) * sizeof(Image_Atlas_Node));
+
+			page_nodes[best_page][0] = (Image_Atlas_Node){ 0, 0, page_size };
+
+			page_node_counts[best_page] = 1;
+		}
+
+		page_node_counts[best_page] = image_atlas_insert(page_nodes[best_page], page_node_counts[best_page], best_node, best_y, item->width, item->height);
+
+		const Image* image = images[item->index];
+
+		image_atlas_copy(atlas->pages[best_page], image, best_x + padding, best_y + padding, padding, extrude);
+
+		atlas->entries[item->index] = (Image_Atlas_Entry){ best_page, best_x + padding, best_y + padding, image->width, image->height };
+	}
+
+	for (int page = 0; page < atlas->page_count; page++)
+	{
+		free(page_nodes[page]);
+	}
+
+	free(page_nodes);
+
+	free(page_node_counts);
+
+	free(items);
+
+	return atlas;
+}
+
+Image_Atlas* image_atlas_load(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+
+	if (file == NULL)
+	{
+		return NULL;
+	}
+
+	fseek(file, 0, SEEK_END);
+
+	long long file_size = ftell(file);
+
+	fseek(file, 0, SEEK_SET);
+
+	int header[4];
+
+	bool valid = fread(header, sizeof(header), 1, file) == 1 && header[0] == IMAGE_ATLAS_FILE_MAGIC && header[1] > 0 && header[1] <= IMAGE_SIZE_MAX && header[2] >= 0 && header[3] >= 0;
+
+	valid = valid && sizeof(header) + header[3] * (long long)sizeof(Image_Atlas_Entry) + header[2] * (long long)header[1] * header[1] * 4 <= file_size;
+
+	if (!valid)
+	{
+		fclose(file);
+
+		return NULL;
+	}
+
+	Image_Atlas* atlas = malloc(sizeof(Image_Atlas));
+
+	atlas->page_size = header[1];
+
+	atlas->page_count = header[2];
+
+	atlas->entry_count = header[3];
+
+	atlas->entries = malloc(atlas->entry_count * sizeof(Image_Atlas_Entry));
+
+	atlas->pages = malloc(atlas->page_count * sizeof(Image*));
+
+	valid = fread(atlas->entries, sizeof(Image_Atlas_Entry), atlas->entry_count, file) == atlas->entry_count;
+
+	for (int i = 0; valid && i < atlas->entry_count; i++)
+	{
+		const Image_Atlas_Entry* entry = &atlas->entries[i];
+
+		valid = entry->page >= 0 && entry->page < atlas->page_count && entry->x >= 0 && entry->y >= 0 && entry->width >= 0 && entry->height >= 0 && entry->width <= atlas->page_size - entry->x && entry->height <= atlas->page_size - entry->y;
+	}
+
+	for (int i = 0; i < atlas->page_count; i++)
+	{
+		Image* page = malloc(sizeof(Image));
+
+		page->width = atlas->page_size;
+
+		page->height = atlas->page_size;
+
+		page->pixels = malloc((size_t)atlas->page_size * atlas->page_size * 4);
+
+		valid = valid && fread(page->pixels, atlas->page_size * 4, atlas->page_size, file) == atlas->page_size;
+
+		atlas->pages[i] = page;
+	}
+
+	fclose(file);
+
+	if (!valid)
+	{
+		image_atlas_destroy(atlas);
+
+		return NULL;
+	}
+
+	return atlas;
+}
+
+bool image_atlas_save(const Image_Atlas* atlas, const char* path)
+{
+	FILE* file = fopen(path, "wb");
+
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	int header[4] = { IMAGE_ATLAS_FILE_MAGIC, atlas->page_size, atlas->page_count, atlas->entry_count };
+
+	bool valid = fwrite(header, sizeof(header), 1, file) == 1;
+
+	valid = valid && fwrite(atlas->entries, sizeof(Image_Atlas_Entry), atlas->entry_count, file) == atlas->entry_count;
+
+	for (int i = 0; i < atlas->page_count; i++)
+	{
+		valid = valid && fwrite(atlas->pages[i]->pixels, atlas->page_size * 4, atlas->page_size, file) == atlas->page_size;
+	}
+
+	return fclose(file) == 0 && valid;
+}
+
+void image_atlas_destroy(Image_Atlas* atlas)
+{
+	for (int i = 0; i < atlas->page_count; i++)
+	{
+		image_destroy(atlas->pages[i]);
+	}
+
+	free(atlas->pages);
+
+	free(atlas->entries);
+
+	free(atlas);
+}
+
+Texture* texture_create_from_file(const char* path)
+{
+	File_Mapping* mapping = file_mapping_create(path);
+
+	if (mapping == NULL)
+	{
+		return NULL;
+	}
+
+	Texture* texture = texture_create_from_texture_file(mapping->data, mapping->size);
+
+	if (texture == NULL)
+	{
+		Image* image = image_decode_file(path, mapping);
+
+		if (image != NULL)
+		{
+			texture = texture_create_from_image(image);
+
+			image_destroy(image);
+		}
+	}
+
+	file_mapping_destroy(mapping);
+
+	return texture;
+}
+
+Texture* texture_create_from_pack(const File_Pack* pack, const char* name)
+{
+	size_t size;
+
+	const unsigned char* data = file_pack_find(pack, name, &size);
+
+	if (data == NULL)
+	{
+		return NULL;
+	}
+
+	Texture* texture = texture_create_from_texture_file(data, size);
+
+	if (texture == NULL)
+	{
+		Image* image = image_load_from_pack(pack, name);
+
+		if (image != NULL)
+		{
+			texture = texture_create_from_image(image);
+
+			image_destroy(image);
+		}
+	}
+
+	return texture;
+}
+
+Texture_Request* texture_create_from_file_async(const char* path)
+{
+	Texture_Request* request = calloc(1, sizeof(Texture_Request));
+
+	request->path = malloc(strlen(path) + 1);
+
+	strcpy(request->path, path);
+
+	request->job = thread_job_submit(texture_load_task, request, 1);
+
+	if (s_last_texture_request == NULL)
+	{
+		s_first_texture_request = request;
+	}
+	else
+	{
+		s_last_texture_request->next = request;
+	}
+
+	s_last_texture_request = request;
+
+	return request;
+}
+
+bool texture_request_is_done(const Texture_Request* request)
+{
+	return request->is_done;
+}
+
+Texture* texture_request_wait(Texture_Request* request)
+{
+	if (!request->is_done)
+	{
+		texture_request_finish(request);
+	}
+
+	Texture* texture = request->texture;
+
+	free(request);
+
+	return texture;
+}
+
+Texture* texture_create_from_image(const Image* image)
+{
+	Texture* texture = malloc(sizeof(Texture));
+
+	texture->size = vector_create(image->width, image->height);
+
+	texture->center = vector_create(image->width / 2.0, image->height / 2.0);
+
+	texture->scale = vector_create(1.0, 1.0);
+
+	texture->rect = (Rect){ { 0.0, 0.0 }, { 1.0, 1.0 } };
+
+	texture->premultiplied = false;
+
+	graphics_get_backend()->create_texture(texture, 1, image);
+
+	return texture;
+}
+
+bool texture_file_save(const char* path, const Image* image, Vector size, Vector center, int flags)
+{
+	FILE* file = fopen(path, "wb");
+
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	Image* level = malloc(sizeof(Image));
+
+	level->width = image->width;
+
+	level->height = image->height;
+
+	level->pixels = malloc(image->width * image->height * 4);
+
+	memcpy(level->pixels, image->pixels, image->width * image->height * 4);
+
+	if (flags & TEXTURE_FILE_FLAG_PREMULTIPLIED)
+	{
+		image_premultiply(level);
+	}
+
+	int level_count = 1;
+
+	if (flags & TEXTURE_FILE_FLAG_MIPMAPS)
+	{
+		while ((image->width >> level_count) > 0 || (image->height >> level_count) > 0)
+		{
+			level_count++;
+		}
+	}
+
+	Texture_File_Header header = { TEXTURE_FILE_MAGIC, flags, image->width, image->height, level_count, (sizeof(Texture_File_Header) + TEXTURE_FILE_ALIGNMENT - 1) / TEXTURE_FILE_ALIGNMENT * TEXTURE_FILE_ALIGNMENT, size, center };
+
+	static const unsigned char padding[TEXTURE_FILE_ALIGNMENT];
+
+	size_t padding_size = header.data_offset - sizeof(header);
+
+	bool valid = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(padding, 1, padding_size, file) == padding_size;
+
+	for (int i = 0; i < level_count; i++)
+	{
+		size_t level_size = (size_t)level->width * level->height * 4;
+
+		padding_size = texture_file_get_level_size(level->width, level->height) - level_size;
+
+		valid = valid && fwrite(level->pixels, 1, level_size, file) == level_size && fwrite(padding, 1, padding_size, file) == padding_size;
+
+		if (i + 1 < level_count)
+		{
+			Image* next = image_downsample(level);
+
+			image_destroy(level);
+
+			level = next;
+		}
+	}
+
+	image_destroy(level);
+
+	return fclose(file) == 0 && valid;
+}
+
+bool texture_file_convert(const char* image_path, const char* texture_path, int flags)
+{
+	Image* image = image_load(image_path);
+
+	if (image == NULL)
+	{
+		return false;
+	}
+
+	bool valid = texture_file_save(texture_path, image, vector_create(image->width, image->height), vector_create(image->width / 2.0, image->height / 2.0), flags);
+
+	image_destroy(image);
+
+	return valid;
+}
+
+void texture_destroy(Texture* texture)
+{
+	graphics_flush();
+
+	graphics_forget_text_runs(texture);
+
+	graphics_get_backend()->destroy_texture(texture);
+
+	free(texture);
+}
+
+void texture_resize(Texture* texture, Vector size)
+{
+	texture->center = vector_scale(texture->center, vector_downscale(size, texture->size));
+
+	texture->size = size;
+}
+
+Texture_Atlas* texture_atlas_create(const Image_Atlas* atlas)
+{
+	Texture_Atlas* texture_atlas = malloc(sizeof(Texture_Atlas));
+
+	texture_atlas->page_count = atlas->page_count;
+
+	texture_atlas->pages = malloc(atlas->page_count * sizeof(Texture*));
+
+	for (int i = 0; i < atlas->page_count; i++)
+	{
+		texture_atlas->pages[i] = texture_create_from_image(atlas->pages[i]);
+	}
+
+	texture_atlas->texture_count = atlas->entry_count;
+
+	texture_atlas->textures = malloc(atlas->entry_count * sizeof(Texture*));
+
+	for (int i = 0; i < atlas->entry_count; i++)
+	{
+		const Image_Atlas_Entry* entry = &atlas->entries[i];
+
+		Texture* texture = malloc(sizeof(Texture));
+
+		texture->size = vector_create(entry->width, entry->height);
+
+		texture->center = vector_create(entry->width / 2.0, entry->height / 2.0);
+
+		texture->scale = vector_create(1.0, 1.0);
+
+		texture->id = texture_atlas->pages[entry->page]->id;
+
+		texture->premultiplied = false;
+
+		texture->rect.min = vector_create((double)entry->x / atlas->page_size, (double)entry->y / atlas->page_size);
+
+		texture->rect.max = vector_create((double)(entry->x + entry->width) / atlas->page_size, (double)(entry->y + entry->height) / atlas->page_size);
+
+		texture_atlas->textures[i] = texture;
+	}
+
+	return texture_atlas;
+}
+
+Texture_Atlas* texture_atlas_create_from_file(const char* path)
+{
+	Image_Atlas* atlas = image_atlas_load(path);
+
+	if (atlas == NULL)
+	{
+		return NULL;
+	}
+
+	Texture_Atlas* texture_atlas = texture_atlas_create(atlas);
+
+	image_atlas_destroy(atlas);
+
+	return texture_atlas;
+}
+
+void texture_atlas_destroy(Texture_Atlas* atlas)
+{
+	for (int i = 0; i < atlas->texture_count; i++)
+	{
+		graphics_forget_text_runs(atlas->textures[i]);
+
+		free(atlas->textures[i]);
+	}
+
+	for (int i = 0; i < atlas->page_count; i++)
+	{
+		texture_destroy(atlas->pages[i]);
+	}
+
+	free(atlas->textures);
+
+	free(atlas->pages);
+
+	free(atlas);
+}
+
+Graphics_Sprite_Layer* graphics_sprite_layer_create(double cell_size)
+{
+	Graphics_Sprite_Layer* layer = calloc(1, sizeof(Graphics_Sprite_Layer));
+
+	layer->cell_size = cell_size;
+
+	layer->grid_is_dirty = true;
+
+	return layer;
+}
+
+void graphics_sprite_layer_destroy(Graphics_Sprite_Layer* layer)
+{
+	free(layer->sprites);
+
+	free(layer->cell_starts);
+
+	free(layer->cell_sprites);
+
+	free(layer->visible_sprites);
+
+	free(layer);
+}
+
+int graphics_sprite_layer_add(Graphics_Sprite_Layer* layer, const Texture* texture, const Rect* texture_rect, const Rect* rect)
+{
+	if (layer->sprite_count == layer->sprite_capacity)
+	{
+		layer->sprite_capacity = imax(layer->sprite_capacity * 2, 64);
+
+		layer->sprites = realloc(layer->sprites, layer->sprite_capacity * sizeof(Graphics_Sprite));
+	}
+
+	Graphics_Sprite* sprite = &layer->sprites[layer->sprite_count];
+
+	sprite->texture = texture;
+
+	sprite->texture_rect = *texture_rect;
+
+	sprite->rect.min = vector_create(fmin(rect->min.x, rect->max.x), fmin(rect->min.y, rect->max.y));
+
+	sprite->rect.max = vector_create(fmax(rect->min.x, rect->max.x), fmax(rect->min.y, rect->max.y));
+
+	layer->grid_is_dirty = true;
+
+	return layer->sprite_count++;
+}
+
+void graphics_sprite_layer_clear(Graphics_Sprite_Layer* layer)
+{
+	layer->sprite_count = 0;
+
+	layer->grid_is_dirty = true;
+}
+
+void graphics_set_backend(const Graphics_Backend* backend)
+{
+	graphics_flush();
+
+	s_backend = backend;
+}
+
+const Graphics_Backend* graphics_get_backend()
+{
+	return s_backend != NULL ? s_backend : graphics_software_get_backend();
+}
+
+Graphics_Statistics graphics_get_statistics()
+{
+	return s_statistics;
+}
+
+void graphics_reset_statistics()
+{
+	memset(&s_statistics, 0, sizeof(s_statistics));
+}
+
+void graphics_clear(const Color* color)
+{
+	graphics_add_command(GRAPHICS_COMMAND_TYPE_CLEAR)->color = *color;
+}
+
+void graphics_set_camera(const Rect* rect)
+{
+	s_camera = *rect;
+
+	s_visible_rect_is_dirty = true;
+
+	s_viewport_transform_is_dirty = true;
+
+	graphics_add_command(GRAPHICS_COMMAND_TYPE_SET_CAMERA)->rect = *rect;
+}
+
+static int graphics_get_circle_lod(double radius)
+{
+	if (!s_circle_points_are_ready)
+	{
+		Vector* points = s_circle_points;
+
+		for (int lod = 0; lod < GRAPHICS_CIRCLE_LOD_COUNT; lod++)
+		{
+			int point_count = GRAPHICS_CIRCLE_VERTEX_COUNT_MIN << lod;
+
+			for (int i = 0; i < point_count; i++)
+			{
+				double angle = M_PI * 2.0 * i / point_count;
+
+				points[i] = vector_create(cos(angle), sin(angle));
+			}
+
+			points += point_count;
+
+			s_circle_radii[lod] = GRAPHICS_CIRCLE_TOLERANCE / (1.0 - cos(M_PI / point_count));
+		}
+
+		s_circle_points_are_ready = true;
+	}
+
+	if (s_viewport_size.x <= 0.0 || s_viewport_size.y <= 0.0)
+	{
+		return GRAPHICS_CIRCLE_LOD_DEFAULT;
+	}
+
+	double pixel_scale = fmax(s_viewport_size.x / fabs(s_camera.max.x - s_camera.min.x), s_viewport_size.y / fabs(s_camera.max.y - s_camera.min.y));
+
+	double transform_scale = fmax(hypot(s_transform.xx, s_transform.xy), hypot(s_transform.yx, s_transform.yy));
+
+	double pixel_radius = radius * transform_scale * pixel_scale;
+
+	int lod = 0;
+
+	while (lod < GRAPHICS_CIRCLE_LOD_COUNT - 1 && pixel_radius > s_circle_radii[lod])
+	{
+		lod++;
+	}
+
+	return lod;
+}
+
+static unsigned int graphics_hash_text(const Texture* font, bool format, const char* key)
+{
+	unsigned int hash = 2166136261u ^ (unsigned int)(size_t)font ^ format;
+
+	for (const char* c = key; *c != '\0'; c++)
+	{
+		hash = (hash ^ (unsigned char)*c) * 16777619u;
+	}
+
+	return hash;
+}
+
+static void graphics_set_glyph(Graphics_Vertex vertices[6], const Texture* font, int index, char character)
+{
+	float u_1 = font->rect.min.x + (font->rect.max.x - font->rect.min.x) * (character / 128.0);
+
+	float u_2 = font->rect.min.x + (font->rect.max.x - font->rect.min.x) * ((character + 1) / 128.0);
+
+	Graphics_Vertex quad[4] = { { index, 0.0f, u_1, font->rect.min.y }, { index + 1, 0.0f, u_2, font->rect.min.y }, { index + 1, 1.0f, u_2, font->rect.max.y }, { index, 1.0f, u_1, font->rect.max.y } };
+
+	vertices[0] = quad[0];
+
+	vertices[1] = quad[1];
+
+	vertices[2] = quad[2];
+
+	vertices[3] = quad[0];
+
+	vertices[4] = quad[2];
+
+	vertices[5] = quad[3];
+}
+
+static Graphics_Text_Run* graphics_get_text_run(bool format, const char* key)
+{
+	unsigned int hash = graphics_hash_text(s_font, format, key);
+
+	Graphics_Text_Run* victim = NULL;
+
+	for (int i = 0; i < GRAPHICS_TEXT_CACHE_PROBE_COUNT; i++)
+	{
+		Graphics_Text_Run* run = &s_text_runs[(hash + i) & (GRAPHICS_TEXT_CACHE_SIZE - 1)];
+
+		if (run->key != NULL && run->font == s_font && run->format == format && strcmp(run->key, key) == 0)
+		{
+			run->last_use = ++s_text_use;
+
+			return run;
+		}
+
+		if (victim == NULL || (victim->key != NULL && (run->key == NULL || run->last_use < victim->last_use)))
+		{
+			victim = run;
+		}
+	}
+
+	free(victim->key);
+
+	victim->font = s_font;
+
+	victim->format = format;
+
+	victim->key = malloc(strlen(key) + 1);
+
+	strcpy(victim->key, key);
+
+	victim->length = 0;
+
+	victim->last_use = ++s_text_use;
+
+	return victim;
+}
+
+static void graphics_update_text_run(Graphics_Text_Run* run, const char* text)
+{
+	int length = strlen(text);
+
+	if (length == run->length && (length == 0 || memcmp(run->text, text, length) == 0))
+	{
+		return;
+	}
+
+	if (length > run->capacity)
+	{
+		run->capacity = imax(run->capacity * 2, length);
+
+		run->text = realloc(run->text, run->capacity);
+
+		run->vertices = realloc(run->vertices, run->capacity * 6 * sizeof(Graphics_Vertex));
+	}
+
+	for (int i = 0; i < length; i++)
+	{
+		if (i >= run->length || run->text[i] != text[i])
+		{
+			graphics_set_glyph(&run->vertices[i * 6], run->font, i, text[i]);
+
+			run->text[i] = text[i];
+		}
+	}
+
+	run->length = length;
+}
+
+static void graphics_draw_text_run(const Graphics_Text_Run* run, double x, double y, double character_width, double character_height)
+{
+	if (run->length == 0)
+	{
+		return;
+	}
+
+	Rect bounding_rect = { { fmin(x, x + character_width * run->length), fmin(y, y + character_height) }, { fmax(x, x + character_width * run->length), fmax(y, y + character_height) } };
+
+	if (!graphics_is_visible(&bounding_rect))
+	{
+		return;
+	}
+
+	graphics_set_texture(s_font);
+
+	Graphics_Vertex* vertices = graphics_add_vertices(GRAPHICS_PRIMITIVE_TRIANGLES, run->length * 6);
+
+	unsigned int color = graphics_get_vertex_color(0xFFFFFFFF);
+
+	for (int i = 0; i < run->length * 6; i++)
+	{
+		const Graphics_Vertex* glyph_vertex = &run->vertices[i];
+
+		Vector position = matrix_apply(s_transform, vector_create(x + glyph_vertex->x * character_width, y + glyph_vertex->y * character_height));
+
+		vertices[i].x = position.x;
+
+		vertices[i].y = position.y;
+
+		vertices[i].u = glyph_vertex->u;
+
+		vertices[i].v = glyph_vertex->v;
+
+		vertices[i].color = color;
+	}
+}
+
+static void graphics_draw_text_run_in_rect(const Graphics_Text_Run* run, const Rect* rect, Alignment alignment)
+{
+	double character_width = (rect->max.y - rect->min.y) / s_font->size.y * (s_font->size.x / 128.0);
+
+	double start_x = 0.0;
+
+	switch (alignment)
+	{
+		case ALIGNMENT_LEFT:
+		{
+			start_x = rect->min.x;
+
+			break;
+		}
+		case ALIGNMENT_RIGHT:
+		{
+			start_x = rect->max.x - character_width * run->length;
+
+			break;
+		}
+		case ALIGNMENT_CENTER:
+		{
+			start_x = (rect->min.x + rect->max.x) / 2.0 - character_width * run->length / 2.0;
+
+			break;
+		}
+	}
+
+	graphics_draw_text_run(run, start_x, rect->min.y, character_width, rect->max.y - rect->min.y);
+}
+
+static void graphics_draw_text_run_aligned(const Graphics_Text_Run* run, Alignment horizontal_alignment, Alignment vertical_alignment)
+{
+	double character_width = (s_font->size.x / 128.0) / s_font->size.y;
+
+	double start_x = 0.0;
+
+	double lower_y = 0.0;
+
+	switch (horizontal_alignment)
+	{
+		case ALIGNMENT_LEFT:
+		{
+			start_x = 0.0;
+
+			break;
+		}
+		case ALIGNMENT_RIGHT:
+		{
+			start_x = character_width * -run->length;
+
+			break;
+		}
+		case ALIGNMENT_CENTER:
+		{
+			start_x = character_width * -run->length / 2.0;
+
+			break;
+		}
+	}
+
+	switch (vertical_alignment)
+	{
+		case ALIGNMENT_BOTTOM:
+		{
+			lower_y = 0.0;
+
+			break;
+		}
+		case ALIGNMENT_TOP:
+		{
+			lower_y = -1.0;
+
+			break;
+		}
+		case ALIGNMENT_CENTER:
+		{
+			lower_y = -0.5;
+
+			break;
+		}
+	}
+
+	graphics_draw_text_run(run, start_x, lower_y, character_width, 1.0);
+}
+
+static const char* graphics_format_text(const char* format, va_list args)
+{
+	va_list args_copy;
+
+	va_copy(args_copy, args);
+
+	int length = vsnprintf(s_text, s_text_capacity, format, args_copy);
+
+	va_end(args_copy);
+
+	if (length >= s_text_capacity)
+	{
+		s_text_capacity = imax(s_text_capacity * 2, length + 1);
+
+		s_text = realloc(s_text, s_text_capacity);
+
+		vsnprintf(s_text, s_text_capacity, format, args);
+	}
+
+	return length >= 0 ? s_text : "";
+}
+
+Rect graphics_get_camera()
+{
+	return s_camera;
+}
+
+Rect graphics_get_visible_rect()
+{
+	if (s_visible_rect_is_dirty)
+	{
+		Matrix inverse = graphics_get_inverse_transform();
+
+		Vector corners[4] = { matrix_apply(inverse, s_camera.min), matrix_apply(inverse, vector_create(s_camera.max.x, s_camera.min.y)), matrix_apply(inverse, s_camera.max), matrix_apply(inverse, vector_create(s_camera.min.x, s_camera.max.y)) };
+
+		s_visible_rect = graphics_get_points_bounding_rect(4, corners);
+
+		s_visible_rect_is_dirty = false;
+	}
+
+	return s_visible_rect;
+}
+
+void graphics_set_viewport_size(int width, int height)
+{
+	s_viewport_size = vector_create(width, height);
+
+	s_viewport_transform_is_dirty = true;
+}
+
+Vector graphics_get_viewport_size()
+{
+	return s_viewport_size;
+}
+
+void graphics_set_color(const Color* color)
+{
+	unsigned char channels[4] = { clamp(color->r, 0.0, 1.0) * 255.0 + 0.5, clamp(color->g, 0.0, 1.0) * 255.0 + 0.5, clamp(color->b, 0.0, 1.0) * 255.0 + 0.5, clamp(color->a, 0.0, 1.0) * 255.0 + 0.5 };
+
+	memcpy(&s_color, channels, sizeof(s_color));
+}
+
+void graphics_set_texture(const Texture* texture)
+{
+	s_texture = texture;
+}
+
+const Texture* graphics_get_texture()
+{
+	return s_texture;
+}
+
+void graphics_set_font(const Texture* font)
+{
+	s_font = font;
+}
+
+void graphics_set_batch_sorting(bool sorting)
+{
+	if (s_batch_sorting == sorting)
+	{
+		return;
+	}
 
-	glBindTexture(GL_TEXTURE_2D, 0);
+	graphics_flush();
 
-	return texture;
+	s_batch_sorting = sorting;
 }
 
-void texture_destroy(Texture* texture)
+void graphics_flush()
 {
-	glDeleteTextures(1, &texture->id);
+	if (s_buffer.command_count == 0)
+	{
+		return;
+	}
 
-	free(texture);
-}
+	if (s_batch_sorting)
+	{
+		graphics_sort_draw_commands();
+	}
 
-void texture_resize(Texture* texture, Vector size)
-{
-	texture->center = vector_scale(texture->center, vector_downscale(size, texture->size));
+	graphics_update_statistics();
 
-	texture->size = size;
-}
+	graphics_get_backend()->execute(&s_buffer);
 
-void graphics_clear(const Color* color)
-{
-	glClearColor(color->r, color->g, color->b, color->a);
+	s_buffer.command_count = 0;
 
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	s_buffer.vertex_count = 0;
 }
 
-void graphics_set_camera(const Rect* rect)
+void graphics_upload_textures(double time_budget)
 {
-	glMatrixMode(GL_PROJECTION);
+	double start_time = get_time();
 
-	glLoadIdentity();
+	Texture_Request* request = s_first_texture_request;
 
-	glOrtho(rect->min.x, rect->max.x, rect->min.y, rect->max.y, -1.0, 1.0);
+	while (request != NULL)
+	{
+		Texture_Request* next = request->next;
 
-	glMatrixMode(GL_MODELVIEW);
-}
+		if (thread_job_is_done(request->job))
+		{
+			texture_request_finish(request);
 
-void graphics_set_color(const Color* color)
-{
-	glColor4dv(color);
+			if (get_time() - start_time >= time_budget)
+			{
+				break;
+			}
+		}
+
+		request = next;
+	}
 }
 
-void graphics_set_texture(const Texture* texture)
+void graphics_clear_text_cache()
 {
-	if (s_texture == texture)
+	for (int i = 0; i < GRAPHICS_TEXT_CACHE_SIZE; i++)
 	{
-		return;
-	}
+		free(s_text_runs[i].key);
 
-	s_texture = texture;
+		free(s_text_runs[i].text);
 
-	if (texture != NULL)
-	{
-		glBindTexture(GL_TEXTURE_2D, texture->id);
-	}
-	else
-	{
-		glBindTexture(GL_TEXTURE_2D, 0);
+		free(s_text_runs[i].vertices);
 	}
-}
 
-void graphics_set_font(const Texture* font)
-{
-	s_font = font;
+	memset(s_text_runs, 0, sizeof(s_text_runs));
 }
 
 void graphics_draw_segment(const Segment* segment, bool fill)
 {
-	glBegin(fill ? GL_POLYGON : GL_LINES);
+	Rect bounding_rect = segment_get_bounding_rect(segment);
 
-	glVertex2dv(&segment->a);
+	if (!graphics_is_visible(&bounding_rect))
+	{
+		return;
+	}
+
+	Graphics_Vertex* vertices = graphics_add_vertices(GRAPHICS_PRIMITIVE_LINES, 2);
 
-	glVertex2dv(&segment->b);
+	graphics_set_vertex(&vertices[0], segment->a, vector_create(0.0, 0.0));
 
-	glEnd();
+	graphics_set_vertex(&vertices[1], segment->b, vector_create(0.0, 0.0));
 }
 
 void graphics_draw_circle(const Circle* circle, bool fill)
 {
-	glBegin(fill ? GL_POLYGON : GL_LINE_LOOP);
+	Rect bounding_rect = circle_get_bounding_rect(circle);
 
-	for (double angle = 0.0; angle <= M_PI * 2.0; angle += M_PI / 12.0)
+	if (!graphics_is_visible(&bounding_rect))
 	{
-		glVertex2d(circle->center.x + circle->radius * cos(angle), circle->center.y + circle->radius * sin(angle));
+		return;
 	}
 
-	glEnd();
-}
+	int lod = graphics_get_circle_lod(circle->radius);
 
-void graphics_draw_polygon(const Polygon* polygon, bool fill)
-{
-	glBegin(fill ? GL_POLYGON : GL_LINE_LOOP);
+	int point_count = GRAPHICS_CIRCLE_VERTEX_COUNT_MIN << lod;
 
-	for (int i = 0; i < polygon->point_count; i++)
+	const Vector* unit_points = &s_circle_points[GRAPHICS_CIRCLE_VERTEX_COUNT_MIN * ((1 << lod) - 1)];
+
+	Vector points[GRAPHICS_CIRCLE_VERTEX_COUNT_MAX];
+
+	for (int i = 0; i < point_count; i++)
 	{
-		glVertex2dv(&polygon->points[i]);
+		points[i] = vector_create(circle->center.x + circle->radius * unit_points[i].x, circle->center.y + circle->radius * unit_points[i].y);
 	}
 
-	glEnd();
+	graphics_add_polygon(point_count, points, fill);
+}
+
+void graphics_draw_polygon(const Polygon* polygon, bool fill)
+{
+	graphics_add_polygon(polygon->point_count, polygon->points, fill);
 }
 
 void graphics_draw_shape(const Shape* shape, bool fill)
@@ -252,209 +2134,216 @@ void graphics_draw_shape(const Shape* shape, bool fill)
 	}
 }
 
-void graphics_draw_rect(const Rect* rect, bool fill)
+void graphics_draw_lines(int vertex_count, const Vector vertices[])
 {
-	glBegin(fill ? GL_QUADS : GL_LINE_LOOP);
-
-	glVertex2d(rect->min.x, rect->min.y);
+	Graphics_Vertex* batch_vertices = graphics_add_vertices(GRAPHICS_PRIMITIVE_LINES, vertex_count);
 
-	glVertex2d(rect->max.x, rect->min.y);
-
-	glVertex2d(rect->max.x, rect->max.y);
-
-	glVertex2d(rect->min.x, rect->max.y);
-
-	glEnd();
+	for (int i = 0; i < vertex_count; i++)
+	{
+		graphics_set_vertex(&batch_vertices[i], vertices[i], vector_create(0.0, 0.0));
+	}
 }
 
-void graphics_draw_texture()
+void graphics_draw_mesh(int vertex_count, const Graphics_Vertex vertices[])
 {
-	if (s_texture == NULL)
+	if (vertex_count == 0)
 	{
 		return;
 	}
-	
-	Vector scaled_center = vector_scale(s_texture->center, s_texture->scale);
-	
-	Vector scaled_size = vector_scale(s_texture->size, s_texture->scale);
 
-	glBegin(GL_QUADS);
+	Graphics_Vertex* batch_vertices = graphics_add_vertices(GRAPHICS_PRIMITIVE_TRIANGLES, vertex_count);
+
+	Matrix transform = s_transform;
 
-	glTexCoord2d(0.0, 0.0);
+	Rect texture_rect = s_texture != NULL ? s_texture->rect : (Rect){ { 0.0, 0.0 }, { 1.0, 1.0 } };
 
-	glVertex2d(-scaled_center.x, -scaled_center.y);
+	Vector texture_size = vector_subtract(texture_rect.max, texture_rect.min);
 
-	glTexCoord2d(1.0, 0.0);
+	bool keeps_color = s_color == 0xFFFFFFFF && (s_texture == NULL || !s_texture->premultiplied);
 
-	glVertex2d(-scaled_center.x + scaled_size.x, -scaled_center.y);
+	for (int i = 0; i < vertex_count; i++)
+	{
+		const Graphics_Vertex* vertex = &vertices[i];
 
-	glTexCoord2d(1.0, 1.0);
+		batch_vertices[i].x = transform.xx * vertex->x + transform.yx * vertex->y + transform.x;
 
-	glVertex2d(-scaled_center.x + scaled_size.x, -scaled_center.y + scaled_size.y);
+		batch_vertices[i].y = transform.xy * vertex->x + transform.yy * vertex->y + transform.y;
 
-	glTexCoord2d(0.0, 1.0);
+		batch_vertices[i].u = texture_rect.min.x + texture_size.x * vertex->u;
 
-	glVertex2d(-scaled_center.x, -scaled_center.y + scaled_size.y);
+		batch_vertices[i].v = texture_rect.min.y + texture_size.y * vertex->v;
 
-	glEnd();
+		batch_vertices[i].color = keeps_color ? vertex->color : graphics_get_vertex_color(vertex->color);
+	}
 }
 
-void graphics_draw_texture_at(Vector position, double angle)
+void graphics_draw_rect(const Rect* rect, bool fill)
+{
+	Vector points[4] = { { rect->min.x, rect->min.y }, { rect->max.x, rect->min.y }, { rect->max.x, rect->max.y }, { rect->min.x, rect->max.y } };
+
+	graphics_add_polygon(4, points, fill);
+}
+
+void graphics_draw_texture()
 {
 	if (s_texture == NULL)
 	{
 		return;
 	}
+	
+	Vector scaled_center = vector_scale(s_texture->center, s_texture->scale);
+	
+	Vector scaled_size = vector_scale(s_texture->size, s_texture->scale);
 
-	graphics_store();
-
-	graphics_translate(position);
-
-	graphics_rotate(angle);
+	Vector min = vector_negate(scaled_center);
 
-	graphics_draw_texture();
+	Vector max = vector_add(min, scaled_size);
 
-	graphics_restore();
+	graphics_draw_texture_in_rect(&(Rect){ min, max });
 }
 
-void graphics_draw_texture_in_rect(const Rect* rect)
+void graphics_draw_texture_at(Vector position, double angle)
 {
 	if (s_texture == NULL)
 	{
 		return;
 	}
 
-	glBegin(GL_QUADS);
-
-	glTexCoord2d(0.0, 0.0);
-
-	glVertex2d(rect->min.x, rect->min.y);
-
-	glTexCoord2d(1.0, 0.0);
+	Vector scaled_center = vector_scale(s_texture->center, s_texture->scale);
+	
+	Vector scaled_size = vector_scale(s_texture->size, s_texture->scale);
 
-	glVertex2d(rect->max.x, rect->min.y);
+	Vector min = vector_negate(scaled_center);
 
-	glTexCoord2d(1.0, 1.0);
+	Vector max = vector_add(min, scaled_size);
 
-	glVertex2d(rect->max.x, rect->max.y);
+	Transform transform = transform_create(position, angle);
 
-	glTexCoord2d(0.0, 1.0);
+	Vector quad[4] = { transform_apply(transform, min), transform_apply(transform, vector_create(max.x, min.y)), transform_apply(transform, max), transform_apply(transform, vector_create(min.x, max.y)) };
 
-	glVertex2d(rect->min.x, rect->max.y);
+	graphics_draw_texture_in_quad(quad);
+}
 
-	glEnd();
+void graphics_draw_texture_in_rect(const Rect* rect)
+{
+	graphics_draw_texture_rect_in_rect(&(Rect){ { 0.0, 0.0 }, { 1.0, 1.0 } }, rect);
 }
 
 void graphics_draw_texture_in_quad(const Vector quad[4])
 {
-	if (s_texture == NULL)
-	{
-		return;
-	}
-
-	glBegin(GL_QUADS);
-
-	glTexCoord2d(0.0, 0.0);
-
-	glVertex2dv(&quad[0]);
-
-	glTexCoord2d(1.0, 0.0);
-
-	glVertex2dv(&quad[1]);
-
-	glTexCoord2d(1.0, 1.0);
+	graphics_draw_texture_rect_in_quad(&(Rect){ { 0.0, 0.0 }, { 1.0, 1.0 } }, quad);
+}
 
-	glVertex2dv(&quad[2]);
+void graphics_draw_texture_rect_in_rect(const Rect* texture_rect, const Rect* rect)
+{
+	Vector quad[4] = { { rect->min.x, rect->min.y }, { rect->max.x, rect->min.y }, { rect->max.x, rect->max.y }, { rect->min.x, rect->max.y } };
 
-	glTexCoord2d(0.0, 1.0);
+	graphics_draw_texture_rect_in_quad(texture_rect, quad);
+}
 
-	glVertex2dv(&quad[3]);
+void graphics_draw_texture_rect_in_quad(const Rect* texture_rect, const Vector quad[4])
+{
+	Vector texture_quad[4] = { { texture_rect->min.x, texture_rect->min.y }, { texture_rect->max.x, texture_rect->min.y }, { texture_rect->max.x, texture_rect->max.y }, { texture_rect->min.x, texture_rect->max.y } };
 
-	glEnd();
+	graphics_draw_texture_quad_in_quad(texture_quad, quad);
 }
 
-void graphics_draw_texture_rect_in_rect(const Rect* texture_rect, const Rect* rect)
+void graphics_draw_texture_quad_in_quad(const Vector texture_quad[4], const Vector quad[4])
 {
 	if (s_texture == NULL)
 	{
 		return;
 	}
 
-	glBegin(GL_QUADS);
+	Rect bounding_rect = graphics_get_points_bounding_rect(4, quad);
 
-	glTexCoord2d(texture_rect->min.x, texture_rect->min.y);
-
-	glVertex2d(rect->min.x, rect->min.y);
+	if (!graphics_is_visible(&bounding_rect))
+	{
+		return;
+	}
 
-	glTexCoord2d(texture_rect->max.x, texture_rect->min.y);
+	Graphics_Vertex* vertices = graphics_add_vertices(GRAPHICS_PRIMITIVE_TRIANGLES, 6);
 
-	glVertex2d(rect->max.x, rect->min.y);
+	graphics_set_vertex(&vertices[0], quad[0], texture_quad[0]);
 
-	glTexCoord2d(texture_rect->max.x, texture_rect->max.y);
+	graphics_set_vertex(&vertices[1], quad[1], texture_quad[1]);
 
-	glVertex2d(rect->max.x, rect->max.y);
+	graphics_set_vertex(&vertices[2], quad[2], texture_quad[2]);
 
-	glTexCoord2d(texture_rect->min.x, texture_rect->max.y);
+	graphics_set_vertex(&vertices[3], quad[0], texture_quad[0]);
 
-	glVertex2d(rect->min.x, rect->max.y);
+	graphics_set_vertex(&vertices[4], quad[2], texture_quad[2]);
 
-	glEnd();
+	graphics_set_vertex(&vertices[5], quad[3], texture_quad[3]);
 }
 
-void graphics_draw_texture_rect_in_quad(const Rect* texture_rect, const Vector quad[4])
+void graphics_draw_sprite_layer(Graphics_Sprite_Layer* layer)
 {
-	if (s_texture == NULL)
+	if (layer->sprite_count == 0)
 	{
 		return;
 	}
 
-	glBegin(GL_QUADS);
-
-	glTexCoord2d(texture_rect->min.x, texture_rect->min.y);
-
-	glVertex2dv(&quad[0]);
+	if (layer->grid_is_dirty)
+	{
+		graphics_sprite_layer_build_grid(layer);
+	}
 
-	glTexCoord2d(texture_rect->max.x, texture_rect->min.y);
+	Rect visible_rect = graphics_get_visible_rect();
 
-	glVertex2dv(&quad[1]);
+	if (!test_rect_rect(&visible_rect, &layer->bounding_rect))
+	{
+		return;
+	}
 
-	glTexCoord2d(texture_rect->max.x, texture_rect->max.y);
+	int min_x = graphics_sprite_layer_get_cell(layer, visible_rect.min.x, layer->bounding_rect.min.x, layer->cell_count_x);
 
-	glVertex2dv(&quad[2]);
+	int min_y = graphics_sprite_layer_get_cell(layer, visible_rect.min.y, layer->bounding_rect.min.y, layer->cell_count_y);
 
-	glTexCoord2d(texture_rect->min.x, texture_rect->max.y);
+	int max_x = graphics_sprite_layer_get_cell(layer, visible_rect.max.x, layer->bounding_rect.min.x, layer->cell_count_x);
 
-	glVertex2dv(&quad[3]);
+	int max_y = graphics_sprite_layer_get_cell(layer, visible_rect.max.y, layer->bounding_rect.min.y, layer->cell_count_y);
 
-	glEnd();
-}
+	int visible_sprite_count = 0;
 
-void graphics_draw_texture_quad_in_quad(const Vector texture_quad[4], const Vector quad[4])
-{
-	if (s_texture == NULL)
+	for (int cell_y = min_y; cell_y <= max_y; cell_y++)
 	{
-		return;
-	}
+		for (int cell_x = min_x; cell_x <= max_x; cell_x++)
+		{
+			int cell = cell_y * layer->cell_count_x + cell_x;
 
-	glBegin(GL_QUADS);
+			for (int i = layer->cell_starts[cell]; i < layer->cell_starts[cell + 1]; i++)
+			{
+				int sprite_index = layer->cell_sprites[i];
+
+				const Rect* rect = &layer->sprites[sprite_index].rect;
 
-	glTexCoord2dv(&texture_quad[0]);
+				int first_x = imax(graphics_sprite_layer_get_cell(layer, rect->min.x, layer->bounding_rect.min.x, layer->cell_count_x), min_x);
 
-	glVertex2dv(&quad[0]);
+				int first_y = imax(graphics_sprite_layer_get_cell(layer, rect->min.y, layer->bounding_rect.min.y, layer->cell_count_y), min_y);
 
-	glTexCoord2dv(&texture_quad[1]);
+				if (cell_x == first_x && cell_y == first_y && test_rect_rect(rect, &visible_rect))
+				{
+					layer->visible_sprites[visible_sprite_count++] = sprite_index;
+				}
+			}
+		}
+	}
 
-	glVertex2dv(&quad[1]);
+	qsort(layer->visible_sprites, visible_sprite_count, sizeof(int), graphics_sprite_compare);
 
-	glTexCoord2dv(&texture_quad[2]);
+	const Texture* texture = s_texture;
 
-	glVertex2dv(&quad[2]);
+	for (int i = 0; i < visible_sprite_count; i++)
+	{
+		const Graphics_Sprite* sprite = &layer->sprites[layer->visible_sprites[i]];
 
-	glTexCoord2dv(&texture_quad[3]);
+		graphics_set_texture(sprite->texture);
 
-	glVertex2dv(&quad[3]);
+		graphics_draw_texture_rect_in_rect(&sprite->texture_rect, &sprite->rect);
+	}
 
-	glEnd();
+	graphics_set_texture(texture);
 }
 
 void graphics_draw_character(const Rect* rect, char character)
@@ -466,168 +2355,140 @@ void graphics_draw_character(const Rect* rect, char character)
 
 void graphics_draw_string_in_rect(const Rect* rect, Alignment alignment, const char* string)
 {
-	int string_length = strlen(string);
-
-	double character_width = (rect->max.y - rect->min.y) / s_font->size.y * (s_font->size.x / 128.0);
-
-	switch (alignment)
-	{
-		case ALIGNMENT_LEFT:
-		{
-			for (int i = 0; i < string_length; i++)
-			{
-				graphics_draw_character(&(Rect){ { rect->min.x + character_width * i, rect->min.y }, { rect->min.x + character_width * (i + 1), rect->max.y } }, string[i]);
-			}
-
-			break;
-		}
-		case ALIGNMENT_RIGHT:
-		{
-			for (int i = 0; i < string_length; i++)
-			{
-				graphics_draw_character(&(Rect){ { rect->max.x - character_width * (string_length - i), rect->min.y }, { rect->max.x - character_width * (string_length - i - 1), rect->max.y } }, string[i]);
-			}
-
-			break;
-		}
-		case ALIGNMENT_CENTER:
-		{
-			double start_x = (rect->min.x + rect->max.x) / 2.0 - character_width * string_length / 2.0;
+	Graphics_Text_Run* run = graphics_get_text_run(false, string);
 
-			for (int i = 0; i < string_length; i++)
-			{
-				graphics_draw_character(&(Rect){ { start_x + character_width * i, rect->min.y }, { start_x + character_width * (i + 1), rect->max.y } }, string[i]);
-			}
+	graphics_update_text_run(run, string);
 
-			break;
-		}
-	}
+	graphics_draw_text_run_in_rect(run, rect, alignment);
 }
 
 void graphics_draw_format_in_rect(const Rect* rect, Alignment alignment, const char* format, ...)
 {
-	char string[120];
-
 	va_list args;
 
 	va_start(args, format);
 
-	vsprintf(string, format, args);
+	const char* string = graphics_format_text(format, args);
 
 	va_end(args);
 
-	graphics_draw_string_in_rect(rect, alignment, string);
+	Graphics_Text_Run* run = graphics_get_text_run(true, format);
+
+	graphics_update_text_run(run, string);
+
+	graphics_draw_text_run_in_rect(run, rect, alignment);
 }
 
 void graphics_draw_string(Alignment horizontal_alignment, Alignment vertical_alignment, const char* string)
 {
-	int string_length = strlen(string);
+	Graphics_Text_Run* run = graphics_get_text_run(false, string);
 
-	double character_width = (s_font->size.x / 128.0) / s_font->size.y;
-
-	double start_x = 0.0;
-
-	double lower_y = 0.0;
-
-	double upper_y = 0.0;
-
-	switch (horizontal_alignment)
-	{
-		case ALIGNMENT_LEFT:
-		{
-			start_x = 0.0;
+	graphics_update_text_run(run, string);
 
-			break;
-		}
-		case ALIGNMENT_RIGHT:
-		{
-			start_x = character_width * -string_length;
+	graphics_draw_text_run_aligned(run, horizontal_alignment, vertical_alignment);
+}
 
-			break;
-		}
-		case ALIGNMENT_CENTER:
-		{
-			start_x = character_width * -string_length / 2.0;
+void graphics_draw_format(Alignment horizontal_alignment, Alignment vertical_alignment, const char* format, ...)
+{
+	va_list args;
 
-			break;
-		}
-	}
+	va_start(args, format);
 
-	switch (vertical_alignment)
-	{
-		case ALIGNMENT_BOTTOM:
-		{
-			lower_y = 0.0;
+	const char* string = graphics_format_text(format, args);
 
-			upper_y = 1.0;
+	va_end(args);
 
-			break;
-		}
-		case ALIGNMENT_TOP:
-		{
-			lower_y = -1.0;
+	Graphics_Text_Run* run = graphics_get_text_run(true, format);
 
-			upper_y = 0.0;
+	graphics_update_text_run(run, string);
 
-			break;
-		}
-		case ALIGNMENT_CENTER:
-		{
-			lower_y = -0.5;
+	graphics_draw_text_run_aligned(run, horizontal_alignment, vertical_alignment);
+}
 
-			upper_y = 0.5;
+void graphics_store()
+{
+	if (s_transform_count == s_transform_capacity)
+	{
+		s_transform_capacity = imax(s_transform_capacity * 2, 16);
 
-			break;
-		}
+		s_transforms = realloc(s_transforms, s_transform_capacity * sizeof(Matrix));
 	}
 
-	for (int i = 0; i < string_length; i++)
+	s_transforms[s_transform_count++] = s_transform;
+}
+
+void graphics_restore()
+{
+	if (s_transform_count > 0)
 	{
-		graphics_draw_character(&(Rect){ { start_x + character_width * i, lower_y }, { start_x + character_width * (i + 1), upper_y } }, string[i]);
+		graphics_set_transform(s_transforms[--s_transform_count]);
 	}
 }
 
-void graphics_draw_format(Alignment horizontal_alignment, Alignment vertical_alignment, const char* format, ...)
+void graphics_translate(Vector translation)
 {
-	char string[120];
-
-	va_list args;
-
-	va_start(args, format);
-
-	vsprintf(string, format, args);
+	graphics_set_transform(matrix_translate(s_transform, translation));
+}
 
-	va_end(args);
+void graphics_rotate(double angle)
+{
+	graphics_set_transform(matrix_rotate(s_transform, angle));
+}
 
-	graphics_draw_string(horizontal_alignment, vertical_alignment, string);
+void graphics_scale(Vector factor)
+{
+	graphics_set_transform(matrix_scale(s_transform, factor));
 }
 
-void graphics_store()
+void graphics_scale_uniformly(double factor)
 {
-	glPushMatrix();
+	graphics_scale(vector_create(factor, factor));
 }
 
-void graphics_restore()
+Matrix graphics_get_transform()
 {
-	glPopMatrix();
+	return s_transform;
 }
 
-void graphics_translate(Vector translation)
+int graphics_get_transform_level()
 {
-	glTranslated(translation.x, translation.y, 0.0);
+	return s_transform_count;
 }
 
-void graphics_rotate(double angle)
+Vector graphics_unproject(Vector point)
 {
-	glRotated(angle * 180.0 / M_PI, 0.0, 0.0, 1.0);
+	return graphics_unproject_at_level(point, s_transform_count);
 }
 
-void graphics_scale(Vector factor)
+Vector graphics_unproject_at_level(Vector point, int level)
 {
-	glScaled(factor.x, factor.y, 1.0);
+	if (s_viewport_transform_is_dirty)
+	{
+		Rect viewport = { { 0.0, fmax(s_viewport_size.y, 1.0) }, { fmax(s_viewport_size.x, 1.0), 0.0 } };
+
+		s_viewport_transform = matrix_create_ortho(&viewport, &s_camera);
+
+		s_viewport_transform_is_dirty = false;
+	}
+
+	point = matrix_apply(s_viewport_transform, point);
+
+	if (level >= s_transform_count)
+	{
+		return matrix_apply(graphics_get_inverse_transform(), point);
+	}
+
+	return matrix_apply(matrix_invert(s_transforms[imax(level, 0)]), point);
 }
 
-void graphics_scale_uniformly(double factor)
+Matrix graphics_get_inverse_transform()
 {
-	glScaled(factor, factor, 1.0);
+	if (s_inverse_transform_is_dirty)
+	{
+		s_inverse_transform = matrix_invert(s_transform);
+
+		s_inverse_transform_is_dirty = false;
+	}
+
+	return s_inverse_transform;
 }
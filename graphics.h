@@ -2,16 +2,78 @@
 
 #include "geometry.h"
 
+#include "file.h"
+
+#include "thread.h"
+
 #include <stdio.h>
 
+#define GRAPHICS_CIRCLE_LOD_COUNT 6
+
+#define GRAPHICS_CIRCLE_LOD_DEFAULT 2
+
+#define GRAPHICS_CIRCLE_VERTEX_COUNT_MIN 8
+
+#define GRAPHICS_CIRCLE_VERTEX_COUNT_MAX (GRAPHICS_CIRCLE_VERTEX_COUNT_MIN << (GRAPHICS_CIRCLE_LOD_COUNT - 1))
+
+#define GRAPHICS_CIRCLE_TOLERANCE 0.5
+
+#define GRAPHICS_TEXTURE_UPLOAD_TIME_BUDGET 0.002
+
+#define GRAPHICS_TEXT_CACHE_SIZE 256
+
+#define GRAPHICS_TEXT_CACHE_PROBE_COUNT 4
+
+#define IMAGE_ATLAS_FILE_MAGIC 0x534C5441
+
+#define TEXTURE_FILE_MAGIC 0x52545854
+
+#define TEXTURE_FILE_ALIGNMENT 64
+
+#define TEXTURE_FILE_LEVEL_COUNT_MAX 16
+
+#define TEXTURE_FILE_FLAG_PREMULTIPLIED 1
+
+#define TEXTURE_FILE_FLAG_MIPMAPS 2
+
 typedef enum Alignment Alignment;
 
+typedef enum Graphics_Primitive Graphics_Primitive;
+
+typedef enum Graphics_Command_Type Graphics_Command_Type;
+
 typedef struct Color Color;
 
 typedef struct Image Image;
 
 typedef struct Texture Texture;
 
+typedef struct Image_Request Image_Request;
+
+typedef struct Texture_Request Texture_Request;
+
+typedef struct Image_Atlas Image_Atlas;
+
+typedef struct Image_Atlas_Entry Image_Atlas_Entry;
+
+typedef struct Texture_Atlas Texture_Atlas;
+
+typedef struct Texture_File_Header Texture_File_Header;
+
+typedef struct Graphics_Sprite Graphics_Sprite;
+
+typedef struct Graphics_Sprite_Layer Graphics_Sprite_Layer;
+
+typedef struct Graphics_Vertex Graphics_Vertex;
+
+typedef struct Graphics_Command Graphics_Command;
+
+typedef struct Graphics_Command_Buffer Graphics_Command_Buffer;
+
+typedef struct Graphics_Backend Graphics_Backend;
+
+typedef struct Graphics_Statistics Graphics_Statistics;
+
 enum Alignment
 {
 	ALIGNMENT_LEFT,
@@ -27,6 +89,26 @@ enum Alignment
 	ALIGNMENT_COUNT
 };
 
+enum Graphics_Primitive
+{
+	GRAPHICS_PRIMITIVE_TRIANGLES,
+
+	GRAPHICS_PRIMITIVE_LINES,
+
+	GRAPHICS_PRIMITIVE_COUNT
+};
+
+enum Graphics_Command_Type
+{
+	GRAPHICS_COMMAND_TYPE_CLEAR,
+
+	GRAPHICS_COMMAND_TYPE_SET_CAMERA,
+
+	GRAPHICS_COMMAND_TYPE_DRAW,
+
+	GRAPHICS_COMMAND_TYPE_COUNT
+};
+
 struct Color
 {
 	double r;
@@ -56,30 +138,297 @@ struct Texture
 	Vector scale;
 
 	int id;
+
+	Rect rect;
+
+	bool premultiplied;
+};
+
+struct Image_Request
+{
+	char* path;
+
+	Image* image;
+
+	Thread_Job* job;
+};
+
+struct Texture_Request
+{
+	char* path;
+
+	File_Mapping* mapping;
+
+	Image* image;
+
+	Thread_Job* job;
+
+	Texture* texture;
+
+	bool is_done;
+
+	Texture_Request* next;
+};
+
+struct Image_Atlas
+{
+	int page_size;
+
+	int page_count;
+
+	Image** pages;
+
+	int entry_count;
+
+	Image_Atlas_Entry* entries;
+};
+
+struct Image_Atlas_Entry
+{
+	int page;
+
+	int x;
+
+	int y;
+
+	int width;
+
+	int height;
+};
+
+struct Texture_Atlas
+{
+	int page_count;
+
+	Texture** pages;
+
+	int texture_count;
+
+	Texture** textures;
+};
+
+struct Texture_File_Header
+{
+	int magic;
+
+	int flags;
+
+	int width;
+
+	int height;
+
+	int level_count;
+
+	int data_offset;
+
+	Vector size;
+
+	Vector center;
+};
+
+struct Graphics_Sprite
+{
+	const Texture* texture;
+
+	Rect texture_rect;
+
+	Rect rect;
+};
+
+struct Graphics_Sprite_Layer
+{
+	double cell_size;
+
+	Graphics_Sprite* sprites;
+
+	int sprite_count;
+
+	int sprite_capacity;
+
+	bool grid_is_dirty;
+
+	Rect bounding_rect;
+
+	int cell_count_x;
+
+	int cell_count_y;
+
+	int* cell_starts;
+
+	int* cell_sprites;
+
+	int* visible_sprites;
+};
+
+struct Graphics_Vertex
+{
+	float x;
+
+	float y;
+
+	float u;
+
+	float v;
+
+	unsigned int color;
+};
+
+struct Graphics_Command
+{
+	Graphics_Command_Type type;
+
+	union
+	{
+		Color color;
+
+		Rect rect;
+
+		struct
+		{
+			Graphics_Primitive primitive;
+
+			int texture_id;
+
+			bool premultiplied;
+
+			int first;
+
+			int count;
+
+			int sequence;
+		};
+	};
+};
+
+struct Graphics_Command_Buffer
+{
+	Graphics_Command* commands;
+
+	int command_count;
+
+	int command_capacity;
+
+	Graphics_Vertex* vertices;
+
+	int vertex_count;
+
+	int vertex_capacity;
+};
+
+struct Graphics_Backend
+{
+	void (* create_texture)(Texture* texture, int level_count, const Image levels[]);
+
+	void (* destroy_texture)(Texture* texture);
+
+	void (* execute)(const Graphics_Command_Buffer* buffer);
+};
+
+struct Graphics_Statistics
+{
+	int flush_count;
+
+	int command_count;
+
+	int state_change_count;
+
+	int draw_count;
+
+	int texture_change_count;
+
+	int vertex_count;
 };
 
 Image* image_load(const char* path);
 
+Image* image_load_from_pack(const File_Pack* pack, const char* name);
+
+Image_Request* image_load_async(const char* path);
+
+bool image_request_is_done(const Image_Request* request);
+
+Image* image_request_wait(Image_Request* request);
+
 void image_destroy(Image* image);
 
+Image_Atlas* image_atlas_create(int image_count, const Image* const images[], int page_size, int padding, bool extrude);
+
+Image_Atlas* image_atlas_load(const char* path);
+
+bool image_atlas_save(const Image_Atlas* atlas, const char* path);
+
+void image_atlas_destroy(Image_Atlas* atlas);
+
 Texture* texture_create_from_file(const char* path);
 
+Texture* texture_create_from_pack(const File_Pack* pack, const char* name);
+
+Texture_Request* texture_create_from_file_async(const char* path);
+
+bool texture_request_is_done(const Texture_Request* request);
+
+Texture* texture_request_wait(Texture_Request* request);
+
 Texture* texture_create_from_image(const Image* image);
 
+bool texture_file_save(const char* path, const Image* image, Vector size, Vector center, int flags);
+
+bool texture_file_convert(const char* image_path, const char* texture_path, int flags);
+
 void texture_destroy(Texture* texture);
 
 void texture_resize(Texture* texture, Vector size);
 
+Texture_Atlas* texture_atlas_create(const Image_Atlas* atlas);
+
+Texture_Atlas* texture_atlas_create_from_file(const char* path);
+
+void texture_atlas_destroy(Texture_Atlas* atlas);
+
+Graphics_Sprite_Layer* graphics_sprite_layer_create(double cell_size);
+
+void graphics_sprite_layer_destroy(Graphics_Sprite_Layer* layer);
+
+int graphics_sprite_layer_add(Graphics_Sprite_Layer* layer, const Texture* texture, const Rect* texture_rect, const Rect* rect);
+
+void graphics_sprite_layer_clear(Graphics_Sprite_Layer* layer);
+
+void graphics_set_backend(const Graphics_Backend* backend);
+
+const Graphics_Backend* graphics_get_backend();
+
+Graphics_Statistics graphics_get_statistics();
+
+void graphics_reset_statistics();
+
 void graphics_clear(const Color* color);
 
 void graphics_set_camera(const Rect* rect);
 
+Rect graphics_get_camera();
+
+void graphics_set_viewport_size(int width, int height);
+
+Vector graphics_get_viewport_size();
+
+Rect graphics_get_visible_rect();
+
 void graphics_set_color(const Color* color);
 
 void graphics_set_texture(const Texture* texture);
 
+const Texture* graphics_get_texture();
+
 void graphics_set_font(const Texture* font);
 
+void graphics_set_batch_sorting(bool sorting);
+
+void graphics_flush();
+
+void graphics_upload_textures(double time_budget);
+
+void graphics_clear_text_cache();
+
 void graphics_draw_segment(const Segment* segment, bool fill);
 
 void graphics_draw_circle(const Circle* circle, bool fill);
@@ -88,6 +437,10 @@ void graphics_draw_polygon(const Polygon* polygon, bool fill);
 
 void graphics_draw_shape(const Shape* shape, bool fill);
 
+void graphics_draw_lines(int vertex_count, const Vector vertices[]);
+
+void graphics_draw_mesh(int vertex_count, const Graphics_Vertex vertices[]);
+
 void graphics_draw_rect(const Rect* rect, bool fill);
 
 void graphics_draw_texture();
@@ -104,6 +457,8 @@ void graphics_draw_texture_rect_in_quad(const Rect* texture_rect, const Vector q
 
 void graphics_draw_texture_quad_in_quad(const Vector texture_quad[4], const Vector quad[4]);
 
+void graphics_draw_sprite_layer(Graphics_Sprite_Layer* layer);
+
 void graphics_draw_character(const Rect* rect, char character);
 
 void graphics_draw_string_in_rect(const Rect* rect, Alignment alignment, const char* string);
@@ -125,3 +480,13 @@ void graphics_rotate(double angle);
 void graphics_scale(Vector factor);
 
 void graphics_scale_uniformly(double factor);
+
+Matrix graphics_get_transform();
+
+Matrix graphics_get_inverse_transform();
+
+int graphics_get_transform_level();
+
+Vector graphics_unproject(Vector point);
+
+Vector graphics_unproject_at_level(Vector point, int level);
@@ -0,0 +1,118 @@
+#include "graphics_gl.h"
+
+#include "platform.h"
+
+static void graphics_gl_create_texture(Texture* texture, int level_count, const Image levels[])
+{
+	glGenTextures(1, &texture->id);
+
+	glBindTexture(GL_TEXTURE_2D, texture->id);
+
+	for (int i = 0; i < level_count; i++)
+	{
+		glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, levels[i].width, levels[i].height, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels[i].pixels);
+	}
+
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, level_count > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+static void graphics_gl_destroy_texture(Texture* texture)
+{
+	glDeleteTextures(1, &texture->id);
+}
+
+static void graphics_gl_execute(const Graphics_Command_Buffer* buffer)
+{
+	int texture_id = -1;
+
+	bool premultiplied = false;
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glEnableClientState(GL_COLOR_ARRAY);
+
+	glVertexPointer(2, GL_FLOAT, sizeof(Graphics_Vertex), &buffer->vertices->x);
+
+	glTexCoordPointer(2, GL_FLOAT, sizeof(Graphics_Vertex), &buffer->vertices->u);
+
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Graphics_Vertex), &buffer->vertices->color);
+
+	for (int i = 0; i < buffer->command_count; i++)
+	{
+		const Graphics_Command* command = &buffer->commands[i];
+
+		switch (command->type)
+		{
+			case GRAPHICS_COMMAND_TYPE_CLEAR:
+			{
+				glClearColor(command->color.r, command->color.g, command->color.b, command->color.a);
+
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+				break;
+			}
+			case GRAPHICS_COMMAND_TYPE_SET_CAMERA:
+			{
+				glMatrixMode(GL_PROJECTION);
+
+				glLoadIdentity();
+
+				glOrtho(command->rect.min.x, command->rect.max.x, command->rect.min.y, command->rect.max.y, -1.0, 1.0);
+
+				glMatrixMode(GL_MODELVIEW);
+
+				glLoadIdentity();
+
+				break;
+			}
+			case GRAPHICS_COMMAND_TYPE_DRAW:
+			{
+				if (command->texture_id != texture_id)
+				{
+					glBindTexture(GL_TEXTURE_2D, command->texture_id);
+
+					texture_id = command->texture_id;
+				}
+
+				if (command->premultiplied != premultiplied)
+				{
+					glBlendFunc(command->premultiplied ? GL_ONE : GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+					premultiplied = command->premultiplied;
+				}
+
+				glDrawArrays(command->primitive == GRAPHICS_PRIMITIVE_LINES ? GL_LINES : GL_TRIANGLES, command->first, command->count);
+
+				break;
+			}
+		}
+	}
+
+	if (premultiplied)
+	{
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+
+	glDisableClientState(GL_COLOR_ARRAY);
+
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+static const Graphics_Backend s_backend = { graphics_gl_create_texture, graphics_gl_destroy_texture, graphics_gl_execute };
+
+const Graphics_Backend* graphics_gl_get_backend()
+{
+	return &s_backend;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "graphics.h"
+
+const Graphics_Backend* graphics_gl_get_backend();
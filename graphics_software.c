@@ -0,0 +1,720 @@
+#include "graphics_software.h"
+
+#include "thread.h"
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#endif
+
+typedef enum Graphics_Software_Primitive_Type Graphics_Software_Primitive_Type;
+
+typedef struct Graphics_Software_Primitive Graphics_Software_Primitive;
+
+typedef struct Graphics_Software_Tile Graphics_Software_Tile;
+
+enum Graphics_Software_Primitive_Type
+{
+	GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_CLEAR,
+
+	GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_TRIANGLE,
+
+	GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_LINE,
+
+	GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_COUNT
+};
+
+struct Graphics_Software_Primitive
+{
+	Graphics_Software_Primitive_Type type;
+
+	Vector points[3];
+
+	Vector texture_points[3];
+
+	unsigned int color;
+
+	const Image* texture;
+
+	bool premultiplied;
+};
+
+struct Graphics_Software_Tile
+{
+	int* primitive_indices;
+
+	int primitive_count;
+
+	int primitive_capacity;
+};
+
+static Image s_framebuffer;
+
+static Image** s_textures;
+
+static int s_texture_count;
+
+static Rect s_camera = { { -1.0, -1.0 }, { 1.0, 1.0 } };
+
+static Graphics_Software_Primitive* s_primitives;
+
+static int s_primitive_count;
+
+static int s_primitive_capacity;
+
+static Graphics_Software_Tile* s_tiles;
+
+static int s_tile_count_x;
+
+static int s_tile_count_y;
+
+static unsigned int graphics_software_pack_color(const Color* color)
+{
+	unsigned char channels[4] = { clamp(color->r, 0.0, 1.0) * 255.0 + 0.5, clamp(color->g, 0.0, 1.0) * 255.0 + 0.5, clamp(color->b, 0.0, 1.0) * 255.0 + 0.5, clamp(color->a, 0.0, 1.0) * 255.0 + 0.5 };
+
+	unsigned int packed_color;
+
+	memcpy(&packed_color, channels, sizeof(packed_color));
+
+	return packed_color;
+}
+
+static unsigned int graphics_software_modulate(unsigned int texel, unsigned int color)
+{
+	if (color == 0xFFFFFFFF)
+	{
+		return texel;
+	}
+
+	const unsigned char* texel_channels = (const unsigned char*)&texel;
+
+	const unsigned char* color_channels = (const unsigned char*)&color;
+
+	unsigned char channels[4];
+
+	for (int i = 0; i < 4; i++)
+	{
+		channels[i] = (texel_channels[i] * color_channels[i] + 127) / 255;
+	}
+
+	unsigned int packed_color;
+
+	memcpy(&packed_color, channels, sizeof(packed_color));
+
+	return packed_color;
+}
+
+static unsigned int graphics_software_shade(const Image* texture, unsigned int color, double u, double v)
+{
+	int x = (int)floor(u * texture->width) % texture->width;
+
+	int y = (int)floor(v * texture->height) % texture->height;
+
+	x += x < 0 ? texture->width : 0;
+
+	y += y < 0 ? texture->height : 0;
+
+	return graphics_software_modulate(((const unsigned int*)texture->pixels)[y * texture->width + x], color);
+}
+
+static void graphics_software_blend(unsigned int* pixel, unsigned int color)
+{
+	unsigned char* destination = (unsigned char*)pixel;
+
+	const unsigned char* source = (const unsigned char*)&color;
+
+	int alpha = source[3];
+
+	if (alpha == 255)
+	{
+		*pixel = color;
+
+		return;
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		destination[i] = (source[i] * alpha + destination[i] * (255 - alpha) + 127) / 255;
+	}
+}
+
+static void graphics_software_blend_premultiplied(unsigned int* pixel, unsigned int color)
+{
+	unsigned char* destination = (unsigned char*)pixel;
+
+	const unsigned char* source = (const unsigned char*)&color;
+
+	int alpha = source[3];
+
+	if (alpha == 255)
+	{
+		*pixel = color;
+
+		return;
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		destination[i] = imin(source[i] + (destination[i] * (255 - alpha) + 127) / 255, 255);
+	}
+}
+
+static void graphics_software_fill_span(unsigned int* pixels, int count, unsigned int color)
+{
+	int alpha = ((const unsigned char*)&color)[3];
+
+	if (alpha == 0)
+	{
+		return;
+	}
+
+	if (alpha == 255)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			pixels[i] = color;
+		}
+
+		return;
+	}
+
+	int i = 0;
+
+#ifdef __SSE2__
+
+	__m128i zero = _mm_setzero_si128();
+
+	__m128i one = _mm_set1_epi16(1);
+
+	__m128i inverse_alpha = _mm_set1_epi16(255 - alpha);
+
+	__m128i source = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(color), zero), _mm_set1_epi16(alpha)), _mm_set1_epi16(127));
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i destination = _mm_loadu_si128((const __m128i*)(pixels + i));
+
+		__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(destination, zero), inverse_alpha), source);
+
+		__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(destination, zero), inverse_alpha), source);
+
+		low = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(low, one), _mm_srli_epi16(low, 8)), 8);
+
+		high = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(high, one), _mm_srli_epi16(high, 8)), 8);
+
+		_mm_storeu_si128((__m128i*)(pixels + i), _mm_packus_epi16(low, high));
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		graphics_software_blend(&pixels[i], color);
+	}
+}
+
+static void graphics_software_texture_span(unsigned int* pixels, int count, const Image* texture, bool premultiplied, unsigned int color, Vector texture_point, Vector texture_step)
+{
+	const unsigned int* texels = texture->pixels;
+
+	double x = texture_point.x * texture->width;
+
+	double y = texture_point.y * texture->height;
+
+	double step_x = texture_step.x * texture->width;
+
+	double step_y = texture_step.y * texture->height;
+
+	for (int i = 0; i < count; i++, x += step_x, y += step_y)
+	{
+		int texel_x = (int)floor(x);
+
+		int texel_y = (int)floor(y);
+
+		if (texel_x < 0 || texel_x >= texture->width)
+		{
+			texel_x %= texture->width;
+
+			texel_x += texel_x < 0 ? texture->width : 0;
+		}
+
+		if (texel_y < 0 || texel_y >= texture->height)
+		{
+			texel_y %= texture->height;
+
+			texel_y += texel_y < 0 ? texture->height : 0;
+		}
+
+		unsigned int texel = graphics_software_modulate(texels[texel_y * texture->width + texel_x], color);
+
+		if (premultiplied)
+		{
+			graphics_software_blend_premultiplied(&pixels[i], texel);
+		}
+		else
+		{
+			graphics_software_blend(&pixels[i], texel);
+		}
+	}
+}
+
+static void graphics_software_draw_triangle(const Graphics_Software_Primitive* primitive, int min_x, int min_y, int max_x, int max_y)
+{
+	const Vector* points = primitive->points;
+
+	double area = vector_cross(vector_subtract(points[1], points[0]), vector_subtract(points[2], points[0]));
+
+	min_x = imax(min_x, (int)floor(fmin(points[0].x, fmin(points[1].x, points[2].x))));
+
+	min_y = imax(min_y, (int)floor(fmin(points[0].y, fmin(points[1].y, points[2].y))));
+
+	max_x = imin(max_x, (int)ceil(fmax(points[0].x, fmax(points[1].x, points[2].x))));
+
+	max_y = imin(max_y, (int)ceil(fmax(points[0].y, fmax(points[1].y, points[2].y))));
+
+	Vector texture_step = vector_create(0.0, 0.0);
+
+	if (primitive->texture != NULL)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			double slope = (points[(i + 2) % 3].y - points[(i + 1) % 3].y) / area;
+
+			texture_step = vector_add(texture_step, vector_multiply(primitive->texture_points[i], -slope));
+		}
+	}
+
+	unsigned int* pixels = s_framebuffer.pixels;
+
+	for (int y = min_y; y < max_y; y++)
+	{
+		double center_y = y + 0.5;
+
+		int span_min = min_x;
+
+		int span_max = max_x;
+
+		for (int i = 0; i < 3 && span_min < span_max; i++)
+		{
+			Vector a = points[i];
+
+			Vector b = points[(i + 1) % 3];
+
+			Vector side = vector_subtract(b, a);
+
+			bool inclusive = side.y < 0.0 || (side.y == 0.0 && side.x < 0.0);
+
+			double slope = -side.y;
+
+			double offset = side.x * (center_y - a.y) + side.y * a.x;
+
+			if (slope == 0.0)
+			{
+				if (offset < 0.0 || (offset == 0.0 && !inclusive))
+				{
+					span_max = span_min;
+				}
+
+				continue;
+			}
+
+			double limit = -offset / slope - 0.5;
+
+			if (slope > 0.0)
+			{
+				span_min = imax(span_min, inclusive ? (int)ceil(limit) : (int)floor(limit) + 1);
+			}
+			else
+			{
+				span_max = imin(span_max, inclusive ? (int)floor(limit) + 1 : (int)ceil(limit));
+			}
+		}
+
+		if (span_min >= span_max)
+		{
+			continue;
+		}
+
+		unsigned int* row = pixels + y * s_framebuffer.width + span_min;
+
+		if (primitive->texture == NULL)
+		{
+			graphics_software_fill_span(row, span_max - span_min, primitive->color);
+
+			continue;
+		}
+
+		Vector point = vector_create(span_min + 0.5, center_y);
+
+		Vector texture_point = vector_create(0.0, 0.0);
+
+		for (int i = 0; i < 3; i++)
+		{
+			Vector a = points[(i + 1) % 3];
+
+			Vector b = points[(i + 2) % 3];
+
+			double weight = vector_cross(vector_subtract(b, a), vector_subtract(point, a)) / area;
+
+			texture_point = vector_add(texture_point, vector_multiply(primitive->texture_points[i], weight));
+		}
+
+		graphics_software_texture_span(row, span_max - span_min, primitive->texture, primitive->premultiplied, primitive->color, texture_point, texture_step);
+	}
+}
+
+static void graphics_software_draw_line(const Graphics_Software_Primitive* primitive, int min_x, int min_y, int max_x, int max_y)
+{
+	Vector start = primitive->points[0];
+
+	Vector offset = vector_subtract(primitive->points[1], start);
+
+	int step_count = imax((int)ceil(fmax(fabs(offset.x), fabs(offset.y))), 1);
+
+	Ray ray = { start, offset };
+
+	Rect rect = { { min_x - 1.0, min_y - 1.0 }, { max_x + 1.0, max_y + 1.0 } };
+
+	if (!test_ray_rect(&ray, 1.0, &rect))
+	{
+		return;
+	}
+
+	unsigned int* pixels = s_framebuffer.pixels;
+
+	for (int i = 0; i < step_count; i++)
+	{
+		double t = (i + 0.5) / step_count;
+
+		int x = (int)floor(start.x + offset.x * t);
+
+		int y = (int)floor(start.y + offset.y * t);
+
+		if (x < min_x || y < min_y || x >= max_x || y >= max_y)
+		{
+			continue;
+		}
+
+		unsigned int color = primitive->color;
+
+		if (primitive->texture != NULL)
+		{
+			Vector texture_point = vector_add(primitive->texture_points[0], vector_multiply(vector_subtract(primitive->texture_points[1], primitive->texture_points[0]), t));
+
+			color = graphics_software_shade(primitive->texture, color, texture_point.x, texture_point.y);
+		}
+
+		if (primitive->premultiplied)
+		{
+			graphics_software_blend_premultiplied(&pixels[y * s_framebuffer.width + x], color);
+		}
+		else
+		{
+			graphics_software_blend(&pixels[y * s_framebuffer.width + x], color);
+		}
+	}
+}
+
+static void graphics_software_draw_tile(void* data, int index)
+{
+	const Graphics_Software_Tile* tile = &s_tiles[index];
+
+	int min_x = index % s_tile_count_x * GRAPHICS_SOFTWARE_TILE_SIZE;
+
+	int min_y = index / s_tile_count_x * GRAPHICS_SOFTWARE_TILE_SIZE;
+
+	int max_x = imin(min_x + GRAPHICS_SOFTWARE_TILE_SIZE, s_framebuffer.width);
+
+	int max_y = imin(min_y + GRAPHICS_SOFTWARE_TILE_SIZE, s_framebuffer.height);
+
+	for (int i = 0; i < tile->primitive_count; i++)
+	{
+		const Graphics_Software_Primitive* primitive = &s_primitives[tile->primitive_indices[i]];
+
+		switch (primitive->type)
+		{
+			case GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_CLEAR:
+			{
+				for (int y = min_y; y < max_y; y++)
+				{
+					unsigned int* row = (unsigned int*)s_framebuffer.pixels + y * s_framebuffer.width;
+
+					for (int x = min_x; x < max_x; x++)
+					{
+						row[x] = primitive->color;
+					}
+				}
+
+				break;
+			}
+			case GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_TRIANGLE:
+			{
+				graphics_software_draw_triangle(primitive, min_x, min_y, max_x, max_y);
+
+				break;
+			}
+			case GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_LINE:
+			{
+				graphics_software_draw_line(primitive, min_x, min_y, max_x, max_y);
+
+				break;
+			}
+		}
+	}
+}
+
+static Graphics_Software_Primitive* graphics_software_add_primitive(Graphics_Software_Primitive_Type type)
+{
+	if (s_primitive_count == s_primitive_capacity)
+	{
+		s_primitive_capacity = imax(s_primitive_capacity * 2, 1024);
+
+		s_primitives = realloc(s_primitives, s_primitive_capacity * sizeof(Graphics_Software_Primitive));
+	}
+
+	Graphics_Software_Primitive* primitive = &s_primitives[s_primitive_count++];
+
+	primitive->type = type;
+
+	primitive->texture = NULL;
+
+	primitive->premultiplied = false;
+
+	return primitive;
+}
+
+static void graphics_software_add_primitives(const Graphics_Command_Buffer* buffer, const Graphics_Command* command)
+{
+	const Image* texture = command->texture_id > 0 && command->texture_id <= s_texture_count ? s_textures[command->texture_id - 1] : NULL;
+
+	Matrix matrix = matrix_create_ortho(&s_camera, &(Rect){ { 0.0, 0.0 }, { s_framebuffer.width, s_framebuffer.height } });
+
+	int point_count = command->primitive == GRAPHICS_PRIMITIVE_LINES ? 2 : 3;
+
+	for (int i = command->first; i + point_count <= command->first + command->count; i += point_count)
+	{
+		const Graphics_Vertex* vertices = &buffer->vertices[i];
+
+		Graphics_Software_Primitive* primitive = graphics_software_add_primitive(point_count == 2 ? GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_LINE : GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_TRIANGLE);
+
+		for (int j = 0; j < point_count; j++)
+		{
+			primitive->points[j] = matrix_apply(matrix, vector_create(vertices[j].x, vertices[j].y));
+
+			primitive->texture_points[j] = vector_create(vertices[j].u, vertices[j].v);
+		}
+
+		primitive->color = vertices[point_count - 1].color;
+
+		primitive->texture = texture;
+
+		primitive->premultiplied = command->premultiplied;
+
+		if (point_count == 3 && vector_cross(vector_subtract(primitive->points[1], primitive->points[0]), vector_subtract(primitive->points[2], primitive->points[0])) < 0.0)
+		{
+			Vector point = primitive->points[1];
+
+			primitive->points[1] = primitive->points[2];
+
+			primitive->points[2] = point;
+
+			point = primitive->texture_points[1];
+
+			primitive->texture_points[1] = primitive->texture_points[2];
+
+			primitive->texture_points[2] = point;
+		}
+		else if (point_count == 3 && vector_cross(vector_subtract(primitive->points[1], primitive->points[0]), vector_subtract(primitive->points[2], primitive->points[0])) == 0.0)
+		{
+			s_primitive_count--;
+		}
+	}
+}
+
+static void graphics_software_bin_primitives()
+{
+	int tile_count_x = (s_framebuffer.width + GRAPHICS_SOFTWARE_TILE_SIZE - 1) / GRAPHICS_SOFTWARE_TILE_SIZE;
+
+	int tile_count_y = (s_framebuffer.height + GRAPHICS_SOFTWARE_TILE_SIZE - 1) / GRAPHICS_SOFTWARE_TILE_SIZE;
+
+	if (tile_count_x * tile_count_y != s_tile_count_x * s_tile_count_y)
+	{
+		for (int i = 0; i < s_tile_count_x * s_tile_count_y; i++)
+		{
+			free(s_tiles[i].primitive_indices);
+		}
+
+		s_tiles = realloc(s_tiles, tile_count_x * tile_count_y * sizeof(Graphics_Software_Tile));
+
+		memset(s_tiles, 0, tile_count_x * tile_count_y * sizeof(Graphics_Software_Tile));
+	}
+
+	s_tile_count_x = tile_count_x;
+
+	s_tile_count_y = tile_count_y;
+
+	for (int i = 0; i < s_tile_count_x * s_tile_count_y; i++)
+	{
+		s_tiles[i].primitive_count = 0;
+	}
+
+	for (int i = 0; i < s_primitive_count; i++)
+	{
+		const Graphics_Software_Primitive* primitive = &s_primitives[i];
+
+		int min_tile_x = 0;
+
+		int min_tile_y = 0;
+
+		int max_tile_x = s_tile_count_x - 1;
+
+		int max_tile_y = s_tile_count_y - 1;
+
+		if (primitive->type != GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_CLEAR)
+		{
+			int point_count = primitive->type == GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_LINE ? 2 : 3;
+
+			Rect rect = { primitive->points[0], primitive->points[0] };
+
+			for (int j = 1; j < point_count; j++)
+			{
+				rect.min = vector_create(fmin(rect.min.x, primitive->points[j].x), fmin(rect.min.y, primitive->points[j].y));
+
+				rect.max = vector_create(fmax(rect.max.x, primitive->points[j].x), fmax(rect.max.y, primitive->points[j].y));
+			}
+
+			if (rect.max.x < 0.0 || rect.max.y < 0.0 || rect.min.x >= s_framebuffer.width || rect.min.y >= s_framebuffer.height)
+			{
+				continue;
+			}
+
+			min_tile_x = imax((int)floor(rect.min.x) / GRAPHICS_SOFTWARE_TILE_SIZE, 0);
+
+			min_tile_y = imax((int)floor(rect.min.y) / GRAPHICS_SOFTWARE_TILE_SIZE, 0);
+
+			max_tile_x = imin((int)floor(rect.max.x) / GRAPHICS_SOFTWARE_TILE_SIZE, s_tile_count_x - 1);
+
+			max_tile_y = imin((int)floor(rect.max.y) / GRAPHICS_SOFTWARE_TILE_SIZE, s_tile_count_y - 1);
+		}
+
+		for (int tile_y = min_tile_y; tile_y <= max_tile_y; tile_y++)
+		{
+			for (int tile_x = min_tile_x; tile_x <= max_tile_x; tile_x++)
+			{
+				Graphics_Software_Tile* tile = &s_tiles[tile_y * s_tile_count_x + tile_x];
+
+				if (tile->primitive_count == tile->primitive_capacity)
+				{
+					tile->primitive_capacity = imax(tile->primitive_capacity * 2, 64);
+
+					tile->primitive_indices = realloc(tile->primitive_indices, tile->primitive_capacity * sizeof(int));
+				}
+
+				tile->primitive_indices[tile->primitive_count++] = i;
+			}
+		}
+	}
+}
+
+static void graphics_software_create_texture(Texture* texture, int level_count, const Image levels[])
+{
+	const Image* image = &levels[0];
+
+	Image* copy = malloc(sizeof(Image));
+
+	copy->width = image->width;
+
+	copy->height = image->height;
+
+	copy->pixels = malloc(image->width * image->height * 4);
+
+	memcpy(copy->pixels, image->pixels, image->width * image->height * 4);
+
+	s_textures = realloc(s_textures, (s_texture_count + 1) * sizeof(Image*));
+
+	s_textures[s_texture_count++] = copy;
+
+	texture->id = s_texture_count;
+}
+
+static void graphics_software_destroy_texture(Texture* texture)
+{
+	Image* image = s_textures[texture->id - 1];
+
+	free(image->pixels);
+
+	free(image);
+
+	s_textures[texture->id - 1] = NULL;
+}
+
+static void graphics_software_execute(const Graphics_Command_Buffer* buffer)
+{
+	s_primitive_count = 0;
+
+	for (int i = 0; i < buffer->command_count; i++)
+	{
+		const Graphics_Command* command = &buffer->commands[i];
+
+		switch (command->type)
+		{
+			case GRAPHICS_COMMAND_TYPE_CLEAR:
+			{
+				graphics_software_add_primitive(GRAPHICS_SOFTWARE_PRIMITIVE_TYPE_CLEAR)->color = graphics_software_pack_color(&command->color);
+
+				break;
+			}
+			case GRAPHICS_COMMAND_TYPE_SET_CAMERA:
+			{
+				s_camera = command->rect;
+
+				break;
+			}
+			case GRAPHICS_COMMAND_TYPE_DRAW:
+			{
+				graphics_software_add_primitives(buffer, command);
+
+				break;
+			}
+		}
+	}
+
+	if (s_primitive_count == 0 || s_framebuffer.width == 0 || s_framebuffer.height == 0)
+	{
+		return;
+	}
+
+	graphics_software_bin_primitives();
+
+	thread_run_parallel(graphics_software_draw_tile, NULL, s_tile_count_x * s_tile_count_y);
+}
+
+static const Graphics_Backend s_backend = { graphics_software_create_texture, graphics_software_destroy_texture, graphics_software_execute };
+
+const Graphics_Backend* graphics_software_get_backend()
+{
+	return &s_backend;
+}
+
+void graphics_software_resize(int width, int height)
+{
+	graphics_flush();
+
+	s_framebuffer.width = width;
+
+	s_framebuffer.height = height;
+
+	graphics_set_viewport_size(width, height);
+
+	s_framebuffer.pixels = realloc(s_framebuffer.pixels, width * height * 4);
+
+	memset(s_framebuffer.pixels, 0, width * height * 4);
+}
+
+const Image* graphics_software_get_framebuffer()
+{
+	graphics_flush();
+
+	return &s_framebuffer;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "graphics.h"
+
+#define GRAPHICS_SOFTWARE_TILE_SIZE 64
+
+const Graphics_Backend* graphics_software_get_backend();
+
+void graphics_software_resize(int width, int height);
+
+const Image* graphics_software_get_framebuffer();
@@ -0,0 +1,1098 @@
+#include "image.h"
+
+#include <limits.h>
+
+typedef struct Image_Bit_Reader Image_Bit_Reader;
+
+typedef struct Image_Huffman Image_Huffman;
+
+struct Image_Bit_Reader
+{
+	const unsigned char* data;
+
+	int size;
+
+	int position;
+
+	unsigned long long bits;
+
+	int bit_count;
+};
+
+struct Image_Huffman
+{
+	unsigned short counts[16];
+
+	unsigned short symbols[288];
+
+	unsigned short fast[1 << IMAGE_HUFFMAN_FAST_BITS];
+};
+
+static const unsigned short s_length_bases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+
+static const unsigned char s_length_extras[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+static const unsigned short s_distance_bases[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+
+static const unsigned char s_distance_extras[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static const unsigned char s_code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+static const int s_png_passes[7][4] = { { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 }, { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 } };
+
+static unsigned int image_read_big_endian(const unsigned char* data)
+{
+	return (unsigned int)data[0] << 24 | (unsigned int)data[1] << 16 | (unsigned int)data[2] << 8 | data[3];
+}
+
+static unsigned int image_read_little_endian(const unsigned char* data, int byte_count)
+{
+	unsigned int value = 0;
+
+	for (int i = byte_count - 1; i >= 0; i--)
+	{
+		value = value << 8 | data[i];
+	}
+
+	return value;
+}
+
+static Image* image_allocate(int width, int height)
+{
+	Image* image = malloc(sizeof(Image));
+
+	image->width = width;
+
+	image->height = height;
+
+	image->pixels = malloc(width * height * 4);
+
+	return image;
+}
+
+static void image_refill_bits(Image_Bit_Reader* reader)
+{
+	while (reader->bit_count <= 56)
+	{
+		unsigned long long byte = reader->position < reader->size ? reader->data[reader->position] : 0;
+
+		reader->position++;
+
+		reader->bits |= byte << reader->bit_count;
+
+		reader->bit_count += 8;
+	}
+}
+
+static int image_read_bits(Image_Bit_Reader* reader, int count)
+{
+	if (reader->bit_count < count)
+	{
+		image_refill_bits(reader);
+	}
+
+	int value = reader->bits & ((1ull << count) - 1);
+
+	reader->bits >>= count;
+
+	reader->bit_count -= count;
+
+	return value;
+}
+
+static bool image_build_huffman(Image_Huffman* huffman, const unsigned char lengths[], int count)
+{
+	memset(huffman->counts, 0, sizeof(huffman->counts));
+
+	memset(huffman->fast, 0, sizeof(huffman->fast));
+
+	for (int i = 0; i < count; i++)
+	{
+		huffman->counts[lengths[i]]++;
+	}
+
+	huffman->counts[0] = 0;
+
+	int left = 1;
+
+	for (int length = 1; length < 16; length++)
+	{
+		left = left * 2 - huffman->counts[length];
+
+		if (left < 0)
+		{
+			return false;
+		}
+	}
+
+	int offsets[16] = { 0 };
+
+	for (int length = 1; length < 15; length++)
+	{
+		offsets[length + 1] = offsets[length] + huffman->counts[length];
+	}
+
+	for (int symbol = 0; symbol < count; symbol++)
+	{
+		if (lengths[symbol] != 0)
+		{
+			huffman->symbols[offsets[lengths[symbol]]++] = symbol;
+		}
+	}
+
+	for (int length = 1, code = 0, index = 0; length <= IMAGE_HUFFMAN_FAST_BITS; length++, code <<= 1)
+	{
+		for (int i = 0; i < huffman->counts[length]; i++, index++, code++)
+		{
+			int reversed = 0;
+
+			for (int bit = 0; bit < length; bit++)
+			{
+				reversed |= (code >> bit & 1) << (length - 1 - bit);
+			}
+
+			for (int j = reversed; j < 1 << IMAGE_HUFFMAN_FAST_BITS; j += 1 << length)
+			{
+				huffman->fast[j] = huffman->symbols[index] << 4 | length;
+			}
+		}
+	}
+
+	return true;
+}
+
+static int image_decode_symbol(Image_Bit_Reader* reader, const Image_Huffman* huffman)
+{
+	if (reader->bit_count < 16)
+	{
+		image_refill_bits(reader);
+	}
+
+	int entry = huffman->fast[reader->bits & ((1 << IMAGE_HUFFMAN_FAST_BITS) - 1)];
+
+	if (entry != 0)
+	{
+		reader->bits >>= entry & 15;
+
+		reader->bit_count -= entry & 15;
+
+		return entry >> 4;
+	}
+
+	int code = 0;
+
+	int first = 0;
+
+	int index = 0;
+
+	for (int length = 1; length < 16; length++)
+	{
+		code |= reader->bits >> (length - 1) & 1;
+
+		int count = huffman->counts[length];
+
+		if (code - first < count)
+		{
+			reader->bits >>= length;
+
+			reader->bit_count -= length;
+
+			return huffman->symbols[index + code - first];
+		}
+
+		index += count;
+
+		first = (first + count) << 1;
+
+		code <<= 1;
+	}
+
+	return -1;
+}
+
+static bool image_read_dynamic_huffman(Image_Bit_Reader* reader, Image_Huffman* literal, Image_Huffman* distance)
+{
+	int literal_count = image_read_bits(reader, 5) + 257;
+
+	int distance_count = image_read_bits(reader, 5) + 1;
+
+	int code_length_count = image_read_bits(reader, 4) + 4;
+
+	if (literal_count > 286 || distance_count > 30)
+	{
+		return false;
+	}
+
+	unsigned char lengths[286 + 30] = { 0 };
+
+	for (int i = 0; i < code_length_count; i++)
+	{
+		lengths[s_code_length_order[i]] = image_read_bits(reader, 3);
+	}
+
+	Image_Huffman code_lengths;
+
+	if (!image_build_huffman(&code_lengths, lengths, 19))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < literal_count + distance_count; )
+	{
+		int symbol = image_decode_symbol(reader, &code_lengths);
+
+		if (symbol < 0)
+		{
+			return false;
+		}
+
+		if (symbol < 16)
+		{
+			lengths[i++] = symbol;
+
+			continue;
+		}
+
+		int value = 0;
+
+		int repeat = 0;
+
+		switch (symbol)
+		{
+			case 16:
+			{
+				if (i == 0)
+				{
+					return false;
+				}
+
+				value = lengths[i - 1];
+
+				repeat = 3 + image_read_bits(reader, 2);
+
+				break;
+			}
+			case 17:
+			{
+				repeat = 3 + image_read_bits(reader, 3);
+
+				break;
+			}
+			default:
+			{
+				repeat = 11 + image_read_bits(reader, 7);
+
+				break;
+			}
+		}
+
+		if (i + repeat > literal_count + distance_count)
+		{
+			return false;
+		}
+
+		while (repeat-- > 0)
+		{
+			lengths[i++] = value;
+		}
+	}
+
+	return image_build_huffman(literal, lengths, literal_count) && image_build_huffman(distance, lengths + literal_count, distance_count);
+}
+
+static void image_build_fixed_huffman(Image_Huffman* literal, Image_Huffman* distance)
+{
+	unsigned char lengths[288];
+
+	for (int i = 0; i < 288; i++)
+	{
+		lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+	}
+
+	image_build_huffman(literal, lengths, 288);
+
+	memset(lengths, 5, 30);
+
+	image_build_huffman(distance, lengths, 30);
+}
+
+static int image_get_png_sample(const unsigned char* row, int index, int depth)
+{
+	switch (depth)
+	{
+		case 8:
+		{
+			return row[index];
+		}
+		case 16:
+		{
+			return row[index * 2] << 8 | row[index * 2 + 1];
+		}
+		default:
+		{
+			int bit = index * depth;
+
+			return row[bit / 8] >> (8 - depth - bit % 8) & ((1 << depth) - 1);
+		}
+	}
+}
+
+static int image_scale_png_sample(int sample, int depth)
+{
+	switch (depth)
+	{
+		case 8:
+		{
+			return sample;
+		}
+		case 16:
+		{
+			return sample >> 8;
+		}
+		default:
+		{
+			return sample * 255 / ((1 << depth) - 1);
+		}
+	}
+}
+
+static void image_unfilter_png_row(unsigned char* row, const unsigned char* previous_row, int filter, int stride, int pixel_size)
+{
+	switch (filter)
+	{
+		case 1:
+		{
+			for (int i = pixel_size; i < stride; i++)
+			{
+				row[i] += row[i - pixel_size];
+			}
+
+			break;
+		}
+		case 2:
+		{
+			for (int i = 0; i < stride; i++)
+			{
+				row[i] += previous_row[i];
+			}
+
+			break;
+		}
+		case 3:
+		{
+			for (int i = 0; i < stride; i++)
+			{
+				int left = i >= pixel_size ? row[i - pixel_size] : 0;
+
+				row[i] += (left + previous_row[i]) / 2;
+			}
+
+			break;
+		}
+		case 4:
+		{
+			for (int i = 0; i < stride; i++)
+			{
+				int left = i >= pixel_size ? row[i - pixel_size] : 0;
+
+				int up = previous_row[i];
+
+				int up_left = i >= pixel_size ? previous_row[i - pixel_size] : 0;
+
+				int estimate = left + up - up_left;
+
+				int left_distance = abs(estimate - left);
+
+				int up_distance = abs(estimate - up);
+
+				int up_left_distance = abs(estimate - up_left);
+
+				row[i] += left_distance <= up_distance && left_distance <= up_left_distance ? left : up_distance <= up_left_distance ? up : up_left;
+			}
+
+			break;
+		}
+	}
+}
+
+static unsigned int image_get_bmp_channel(unsigned int pixel, unsigned int mask)
+{
+	if (mask == 0)
+	{
+		return 255;
+	}
+
+	while ((mask & 1) == 0)
+	{
+		mask >>= 1;
+
+		pixel >>= 1;
+	}
+
+	return (pixel & mask) * 255 / mask;
+}
+
+Image* image_decode(const unsigned char* data, int size)
+{
+	if (size >= 8 && data[0] == 137 && memcmp(data + 1, "PNG", 3) == 0)
+	{
+		return image_decode_png(data, size);
+	}
+
+	if (size >= 2 && memcmp(data, "BM", 2) == 0)
+	{
+		return image_decode_bmp(data, size);
+	}
+
+	if (size >= 4 && memcmp(data, "qoif", 4) == 0)
+	{
+		return image_decode_qoi(data, size);
+	}
+
+	return NULL;
+}
+
+Image* image_decode_png(const unsigned char* data, int size)
+{
+	static const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+	if (size < 33 || memcmp(data, signature, 8) != 0 || memcmp(data + 12, "IHDR", 4) != 0)
+	{
+		return NULL;
+	}
+
+	int width = image_read_big_endian(data + 16);
+
+	int height = image_read_big_endian(data + 20);
+
+	int depth = data[24];
+
+	int color_type = data[25];
+
+	bool interlaced = data[28] == 1;
+
+	int channel_counts[7] = { 1, 0, 3, 1, 2, 0, 4 };
+
+	int channel_count = color_type < 7 ? channel_counts[color_type] : 0;
+
+	bool valid_depth = depth == 8 || (depth == 16 && color_type != 3) || (depth < 8 && (depth & (depth - 1)) == 0 && (color_type == 0 || color_type == 3));
+
+	if (width <= 0 || height <= 0 || width > IMAGE_SIZE_MAX || height > IMAGE_SIZE_MAX || channel_count == 0 || !valid_depth || data[26] != 0 || data[27] != 0 || data[28] > 1)
+	{
+		return NULL;
+	}
+
+	unsigned char palette[256][4];
+
+	memset(palette, 255, sizeof(palette));
+
+	int key[3] = { -1, -1, -1 };
+
+	unsigned char* compressed = NULL;
+
+	int compressed_size = 0;
+
+	int compressed_capacity = 0;
+
+	for (int position = 8; position + 12 <= size; )
+	{
+		unsigned int length = image_read_big_endian(data + position);
+
+		const unsigned char* type = data + position + 4;
+
+		const unsigned char* chunk = data + position + 8;
+
+		if (length > (unsigned int)(size - position - 12))
+		{
+			break;
+		}
+
+		if (memcmp(type, "PLTE", 4) == 0)
+		{
+			for (int i = 0; i < (int)length / 3 && i < 256; i++)
+			{
+				memcpy(palette[i], chunk + i * 3, 3);
+			}
+		}
+		else if (memcmp(type, "tRNS", 4) == 0)
+		{
+			if (color_type == 3)
+			{
+				for (int i = 0; i < (int)length && i < 256; i++)
+				{
+					palette[i][3] = chunk[i];
+				}
+			}
+			else if (length >= channel_count * 2)
+			{
+				for (int i = 0; i < channel_count; i++)
+				{
+					key[i] = chunk[i * 2] << 8 | chunk[i * 2 + 1];
+				}
+			}
+		}
+		else if (memcmp(type, "IDAT", 4) == 0)
+		{
+			if (compressed_size + (int)length > compressed_capacity)
+			{
+				compressed_capacity = imax(compressed_capacity * 2, compressed_size + length);
+
+				compressed = realloc(compressed, compressed_capacity);
+			}
+
+			memcpy(compressed + compressed_size, chunk, length);
+
+			compressed_size += length;
+		}
+		else if (memcmp(type, "IEND", 4) == 0)
+		{
+			break;
+		}
+
+		position += length + 12;
+	}
+
+	int pass_count = interlaced ? 7 : 1;
+
+	int pass_widths[7];
+
+	int pass_heights[7];
+
+	long long raw_size = 0;
+
+	for (int pass = 0; pass < pass_count; pass++)
+	{
+		const int* offset = interlaced ? s_png_passes[pass] : (const int[]){ 0, 0, 1, 1 };
+
+		pass_widths[pass] = (width - offset[0] + offset[2] - 1) / offset[2];
+
+		pass_heights[pass] = (height - offset[1] + offset[3] - 1) / offset[3];
+
+		if (pass_widths[pass] > 0 && pass_heights[pass] > 0)
+		{
+			raw_size += (long long)pass_heights[pass] * (((long long)pass_widths[pass] * channel_count * depth + 7) / 8 + 1);
+		}
+	}
+
+	unsigned char* raw = raw_size <= INT_MAX ? malloc(raw_size) : NULL;
+
+	if (raw == NULL || compressed == NULL || image_inflate(compressed, compressed_size, raw, raw_size) != raw_size)
+	{
+		free(raw);
+
+		free(compressed);
+
+		return NULL;
+	}
+
+	free(compressed);
+
+	Image* image = image_allocate(width, height);
+
+	unsigned char* pixels = image->pixels;
+
+	int pixel_size = imax(channel_count * depth / 8, 1);
+
+	unsigned char* zero_row = calloc(((long long)width * channel_count * depth + 7) / 8 + 1, 1);
+
+	unsigned char* row = raw;
+
+	bool valid = true;
+
+	for (int pass = 0; pass < pass_count && valid; pass++)
+	{
+		if (pass_widths[pass] <= 0 || pass_heights[pass] <= 0)
+		{
+			continue;
+		}
+
+		const int* offset = interlaced ? s_png_passes[pass] : (const int[]){ 0, 0, 1, 1 };
+
+		int stride = (pass_widths[pass] * channel_count * depth + 7) / 8;
+
+		const unsigned char* previous_row = zero_row;
+
+		for (int y = 0; y < pass_heights[pass]; y++)
+		{
+			if (row[0] > 4)
+			{
+				valid = false;
+
+				break;
+			}
+
+			image_unfilter_png_row(row + 1, previous_row, row[0], stride, pixel_size);
+
+			const unsigned char* samples = row + 1;
+
+			int image_y = offset[1] + y * offset[3];
+
+			unsigned char* target_row = pixels + (height - 1 - image_y) * width * 4;
+
+			if (color_type == 6 && depth == 8 && offset[2] == 1)
+			{
+				memcpy(target_row, samples, width * 4);
+			}
+			else
+			{
+				for (int x = 0; x < pass_widths[pass]; x++)
+				{
+					unsigned char* target = target_row + (offset[0] + x * offset[2]) * 4;
+
+					switch (color_type)
+					{
+						case 0:
+						{
+							int gray = image_get_png_sample(samples, x, depth);
+
+							memset(target, image_scale_png_sample(gray, depth), 3);
+
+							target[3] = gray == key[0] ? 0 : 255;
+
+							break;
+						}
+						case 2:
+						{
+							int red = image_get_png_sample(samples, x * 3, depth);
+
+							int green = image_get_png_sample(samples, x * 3 + 1, depth);
+
+							int blue = image_get_png_sample(samples, x * 3 + 2, depth);
+
+							target[0] = image_scale_png_sample(red, depth);
+
+							target[1] = image_scale_png_sample(green, depth);
+
+							target[2] = image_scale_png_sample(blue, depth);
+
+							target[3] = red == key[0] && green == key[1] && blue == key[2] ? 0 : 255;
+
+							break;
+						}
+						case 3:
+						{
+							memcpy(target, palette[image_get_png_sample(samples, x, depth)], 4);
+
+							break;
+						}
+						case 4:
+						{
+							memset(target, image_scale_png_sample(image_get_png_sample(samples, x * 2, depth), depth), 3);
+
+							target[3] = image_scale_png_sample(image_get_png_sample(samples, x * 2 + 1, depth), depth);
+
+							break;
+						}
+						case 6:
+						{
+							for (int i = 0; i < 4; i++)
+							{
+								target[i] = image_scale_png_sample(image_get_png_sample(samples, x * 4 + i, depth), depth);
+							}
+
+							break;
+						}
+					}
+				}
+			}
+
+			previous_row = samples;
+
+			row += stride + 1;
+		}
+	}
+
+	free(zero_row);
+
+	free(raw);
+
+	if (!valid)
+	{
+		image_destroy(image);
+
+		return NULL;
+	}
+
+	return image;
+}
+
+Image* image_decode_bmp(const unsigned char* data, int size)
+{
+	if (size < 54 || memcmp(data, "BM", 2) != 0)
+	{
+		return NULL;
+	}
+
+	int offset = image_read_little_endian(data + 10, 4);
+
+	int header_size = image_read_little_endian(data + 14, 4);
+
+	int width = image_read_little_endian(data + 18, 4);
+
+	int height = image_read_little_endian(data + 22, 4);
+
+	int bit_count = image_read_little_endian(data + 28, 2);
+
+	int compression = image_read_little_endian(data + 30, 4);
+
+	bool top_down = height < 0;
+
+	height = abs(height);
+
+	bool valid_format = (compression == 0 && (bit_count == 1 || bit_count == 4 || bit_count == 8 || bit_count == 16 || bit_count == 24 || bit_count == 32)) || (compression == 3 && (bit_count == 16 || bit_count == 32));
+
+	if (header_size < 40 || width <= 0 || height <= 0 || width > IMAGE_SIZE_MAX || height > IMAGE_SIZE_MAX || !valid_format || 14 + header_size > size)
+	{
+		return NULL;
+	}
+
+	int row_size = (width * bit_count + 31) / 32 * 4;
+
+	if (offset < 0 || (long long)offset + (long long)row_size * height > size)
+	{
+		return NULL;
+	}
+
+	unsigned int masks[4] = { 0x7C00, 0x03E0, 0x001F, 0 };
+
+	if (bit_count == 32)
+	{
+		masks[0] = 0x00FF0000;
+
+		masks[1] = 0x0000FF00;
+
+		masks[2] = 0x000000FF;
+
+		masks[3] = 0xFF000000;
+	}
+
+	if (compression == 3)
+	{
+		if (size < 66)
+		{
+			return NULL;
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			masks[i] = image_read_little_endian(data + 54 + i * 4, 4);
+		}
+
+		masks[3] = header_size >= 56 ? image_read_little_endian(data + 66, 4) : 0;
+	}
+
+	const unsigned char* palette = data + 14 + header_size;
+
+	int palette_count = bit_count <= 8 ? image_read_little_endian(data + 46, 4) : 0;
+
+	if (bit_count <= 8 && (palette_count <= 0 || palette_count > 1 << bit_count))
+	{
+		palette_count = 1 << bit_count;
+	}
+
+	if (palette + palette_count * 4 > data + size)
+	{
+		return NULL;
+	}
+
+	Image* image = image_allocate(width, height);
+
+	unsigned char* pixels = image->pixels;
+
+	bool has_alpha = false;
+
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned char* source = data + offset + y * row_size;
+
+		unsigned char* target = pixels + (top_down ? height - 1 - y : y) * width * 4;
+
+		for (int x = 0; x < width; x++, target += 4)
+		{
+			switch (bit_count)
+			{
+				case 1:
+				case 4:
+				case 8:
+				{
+					int bit = x * bit_count;
+
+					int index = source[bit / 8] >> (8 - bit_count - bit % 8) & ((1 << bit_count) - 1);
+
+					const unsigned char* color = palette + imin(index, palette_count - 1) * 4;
+
+					target[0] = color[2];
+
+					target[1] = color[1];
+
+					target[2] = color[0];
+
+					target[3] = 255;
+
+					break;
+				}
+				case 24:
+				{
+					target[0] = source[x * 3 + 2];
+
+					target[1] = source[x * 3 + 1];
+
+					target[2] = source[x * 3];
+
+					target[3] = 255;
+
+					break;
+				}
+				default:
+				{
+					unsigned int pixel = image_read_little_endian(source + x * bit_count / 8, bit_count / 8);
+
+					for (int i = 0; i < 4; i++)
+					{
+						target[i] = image_get_bmp_channel(pixel, masks[i]);
+					}
+
+					has_alpha |= masks[3] != 0 && (pixel & masks[3]) != 0;
+
+					break;
+				}
+			}
+		}
+	}
+
+	if (masks[3] != 0 && bit_count > 8 && !has_alpha)
+	{
+		for (int i = 0; i < width * height; i++)
+		{
+			pixels[i * 4 + 3] = 255;
+		}
+	}
+
+	return image;
+}
+
+Image* image_decode_qoi(const unsigned char* data, int size)
+{
+	if (size < 22 || memcmp(data, "qoif", 4) != 0)
+	{
+		return NULL;
+	}
+
+	int width = image_read_big_endian(data + 4);
+
+	int height = image_read_big_endian(data + 8);
+
+	if (width <= 0 || height <= 0 || width > IMAGE_SIZE_MAX || height > IMAGE_SIZE_MAX)
+	{
+		return NULL;
+	}
+
+	Image* image = image_allocate(width, height);
+
+	unsigned char* pixels = image->pixels;
+
+	unsigned char index[64][4] = { { 0 } };
+
+	unsigned char pixel[4] = { 0, 0, 0, 255 };
+
+	int position = 14;
+
+	int run = 0;
+
+	for (int y = 0; y < height; y++)
+	{
+		unsigned char* target = pixels + (height - 1 - y) * width * 4;
+
+		for (int x = 0; x < width; x++, target += 4)
+		{
+			if (run > 0)
+			{
+				run--;
+			}
+			else if (position < size)
+			{
+				int tag = data[position++];
+
+				if (tag == 0xFE && position + 3 <= size)
+				{
+					memcpy(pixel, data + position, 3);
+
+					position += 3;
+				}
+				else if (tag == 0xFF && position + 4 <= size)
+				{
+					memcpy(pixel, data + position, 4);
+
+					position += 4;
+				}
+				else if (tag >> 6 == 0)
+				{
+					memcpy(pixel, index[tag], 4);
+				}
+				else if (tag >> 6 == 1)
+				{
+					pixel[0] += (tag >> 4 & 3) - 2;
+
+					pixel[1] += (tag >> 2 & 3) - 2;
+
+					pixel[2] += (tag & 3) - 2;
+				}
+				else if (tag >> 6 == 2 && position < size)
+				{
+					int green = (tag & 63) - 32;
+
+					int next = data[position++];
+
+					pixel[0] += green - 8 + (next >> 4);
+
+					pixel[1] += green;
+
+					pixel[2] += green - 8 + (next & 15);
+				}
+				else if (tag >> 6 == 3 && tag < 0xFE)
+				{
+					run = tag & 63;
+				}
+
+				memcpy(index[(pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64], pixel, 4);
+			}
+
+			memcpy(target, pixel, 4);
+		}
+	}
+
+	return image;
+}
+
+int image_inflate(const unsigned char* data, int size, unsigned char* output, int output_size)
+{
+	if (size < 2 || (data[0] & 15) != 8 || (data[0] << 8 | data[1]) % 31 != 0 || (data[1] & 32) != 0)
+	{
+		return -1;
+	}
+
+	Image_Bit_Reader reader = { data + 2, size - 2, 0, 0, 0 };
+
+	Image_Huffman literal;
+
+	Image_Huffman distance;
+
+	int output_count = 0;
+
+	bool last = false;
+
+	while (!last)
+	{
+		last = image_read_bits(&reader, 1);
+
+		int type = image_read_bits(&reader, 2);
+
+		switch (type)
+		{
+			case 0:
+			{
+				image_read_bits(&reader, reader.bit_count % 8);
+
+				int length = image_read_bits(&reader, 16);
+
+				int complement = image_read_bits(&reader, 16);
+
+				if ((length ^ 0xFFFF) != complement || output_count + length > output_size)
+				{
+					return -1;
+				}
+
+				for (int i = 0; i < length; i++)
+				{
+					output[output_count++] = image_read_bits(&reader, 8);
+				}
+
+				break;
+			}
+			case 1:
+			case 2:
+			{
+				if (type == 1)
+				{
+					image_build_fixed_huffman(&literal, &distance);
+				}
+				else if (!image_read_dynamic_huffman(&reader, &literal, &distance))
+				{
+					return -1;
+				}
+
+				while (true)
+				{
+					int symbol = image_decode_symbol(&reader, &literal);
+
+					if (symbol < 0 || reader.position > reader.size + 8)
+					{
+						return -1;
+					}
+
+					if (symbol < 256)
+					{
+						if (output_count == output_size)
+						{
+							return -1;
+						}
+
+						output[output_count++] = symbol;
+
+						continue;
+					}
+
+					if (symbol == 256)
+					{
+						break;
+					}
+
+					symbol -= 257;
+
+					if (symbol >= 29)
+					{
+						return -1;
+					}
+
+					int length = s_length_bases[symbol] + image_read_bits(&reader, s_length_extras[symbol]);
+
+					int distance_symbol = image_decode_symbol(&reader, &distance);
+
+					if (distance_symbol < 0 || distance_symbol >= 30)
+					{
+						return -1;
+					}
+
+					int offset = s_distance_bases[distance_symbol] + image_read_bits(&reader, s_distance_extras[distance_symbol]);
+
+					if (offset > output_count || output_count + length > output_size)
+					{
+						return -1;
+					}
+
+					unsigned char* target = output + output_count;
+
+					for (int i = 0; i < length; i++)
+					{
+						target[i] = target[i - offset];
+					}
+
+					output_count += length;
+				}
+
+				break;
+			}
+			default:
+			{
+				return -1;
+			}
+		}
+
+		if (reader.position - reader.bit_count / 8 > reader.size)
+		{
+			return -1;
+		}
+	}
+
+	return output_count;
+}
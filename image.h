@@ -0,0 +1,17 @@
+#pragma once
+
+#include "graphics.h"
+
+#define IMAGE_SIZE_MAX 16384
+
+#define IMAGE_HUFFMAN_FAST_BITS 10
+
+Image* image_decode(const unsigned char* data, int size);
+
+Image* image_decode_png(const unsigned char* data, int size);
+
+Image* image_decode_bmp(const unsigned char* data, int size);
+
+Image* image_decode_qoi(const unsigned char* data, int size);
+
+int image_inflate(const unsigned char* data, int size, unsigned char* output, int output_size);
@@ -0,0 +1,258 @@
+#include "particle.h"
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#endif
+
+static unsigned int particle_pack_color(float r, float g, float b, float a)
+{
+	return (unsigned int)(r + 0.5f) | (unsigned int)(g + 0.5f) << 8 | (unsigned int)(b + 0.5f) << 16 | (unsigned int)(a + 0.5f) << 24;
+}
+
+static void particle_system_remove(Particle_System* system, int index)
+{
+	int last = --system->particle_count;
+
+	system->position_x[index] = system->position_x[last];
+
+	system->position_y[index] = system->position_y[last];
+
+	system->velocity_x[index] = system->velocity_x[last];
+
+	system->velocity_y[index] = system->velocity_y[last];
+
+	system->age[index] = system->age[last];
+
+	system->age_rate[index] = system->age_rate[last];
+
+	system->size[index] = system->size[last];
+
+	system->color[index] = system->color[last];
+}
+
+Particle_System* particle_system_create(int particle_capacity)
+{
+	Particle_System* system = calloc(1, sizeof(Particle_System));
+
+	system->drag = 0.0;
+
+	system->start_size = 1.0;
+
+	system->end_size = 1.0;
+
+	system->start_color = (Color){ 1.0, 1.0, 1.0, 1.0 };
+
+	system->end_color = (Color){ 1.0, 1.0, 1.0, 0.0 };
+
+	system->particle_capacity = imax(particle_capacity, 1);
+
+	system->position_x = malloc(system->particle_capacity * sizeof(float));
+
+	system->position_y = malloc(system->particle_capacity * sizeof(float));
+
+	system->velocity_x = malloc(system->particle_capacity * sizeof(float));
+
+	system->velocity_y = malloc(system->particle_capacity * sizeof(float));
+
+	system->age = malloc(system->particle_capacity * sizeof(float));
+
+	system->age_rate = malloc(system->particle_capacity * sizeof(float));
+
+	system->size = malloc(system->particle_capacity * sizeof(float));
+
+	system->color = malloc(system->particle_capacity * sizeof(unsigned int));
+
+	system->vertices = malloc(system->particle_capacity * 6 * sizeof(Graphics_Vertex));
+
+	return system;
+}
+
+void particle_system_destroy(Particle_System* system)
+{
+	free(system->position_x);
+
+	free(system->position_y);
+
+	free(system->velocity_x);
+
+	free(system->velocity_y);
+
+	free(system->age);
+
+	free(system->age_rate);
+
+	free(system->size);
+
+	free(system->color);
+
+	free(system->vertices);
+
+	free(system);
+}
+
+void particle_system_emit(Particle_System* system, Vector position, Vector velocity, double lifetime)
+{
+	if (system->particle_count == system->particle_capacity || lifetime <= 0.0)
+	{
+		return;
+	}
+
+	int index = system->particle_count++;
+
+	system->position_x[index] = position.x;
+
+	system->position_y[index] = position.y;
+
+	system->velocity_x[index] = velocity.x;
+
+	system->velocity_y[index] = velocity.y;
+
+	system->age[index] = 0.0f;
+
+	system->age_rate[index] = 1.0 / lifetime;
+
+	system->size[index] = system->start_size;
+
+	system->color[index] = particle_pack_color(clamp(system->start_color.r, 0.0, 1.0) * 255.0, clamp(system->start_color.g, 0.0, 1.0) * 255.0, clamp(system->start_color.b, 0.0, 1.0) * 255.0, clamp(system->start_color.a, 0.0, 1.0) * 255.0);
+}
+
+void particle_system_update(Particle_System* system, double delta_time)
+{
+	float dt = delta_time;
+
+	float damping = exp(-system->drag * delta_time);
+
+	float gravity_x = system->gravity.x * delta_time;
+
+	float gravity_y = system->gravity.y * delta_time;
+
+	float start_size = system->start_size;
+
+	float size_range = system->end_size - system->start_size;
+
+	float start_color[4] = { clamp(system->start_color.r, 0.0, 1.0) * 255.0, clamp(system->start_color.g, 0.0, 1.0) * 255.0, clamp(system->start_color.b, 0.0, 1.0) * 255.0, clamp(system->start_color.a, 0.0, 1.0) * 255.0 };
+
+	float color_range[4] = { clamp(system->end_color.r, 0.0, 1.0) * 255.0 - start_color[0], clamp(system->end_color.g, 0.0, 1.0) * 255.0 - start_color[1], clamp(system->end_color.b, 0.0, 1.0) * 255.0 - start_color[2], clamp(system->end_color.a, 0.0, 1.0) * 255.0 - start_color[3] };
+
+	int i = 0;
+
+#ifdef __SSE2__
+
+	__m128 dt_4 = _mm_set1_ps(dt);
+
+	__m128 damping_4 = _mm_set1_ps(damping);
+
+	__m128 gravity_x_4 = _mm_set1_ps(gravity_x);
+
+	__m128 gravity_y_4 = _mm_set1_ps(gravity_y);
+
+	__m128 one_4 = _mm_set1_ps(1.0f);
+
+	__m128 half_4 = _mm_set1_ps(0.5f);
+
+	__m128i shift_4[4] = { _mm_cvtsi32_si128(0), _mm_cvtsi32_si128(8), _mm_cvtsi32_si128(16), _mm_cvtsi32_si128(24) };
+
+	for (; i + 4 <= system->particle_count; i += 4)
+	{
+		__m128 age = _mm_add_ps(_mm_loadu_ps(system->age + i), _mm_mul_ps(_mm_loadu_ps(system->age_rate + i), dt_4));
+
+		__m128 velocity_x = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(system->velocity_x + i), damping_4), gravity_x_4);
+
+		__m128 velocity_y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(system->velocity_y + i), damping_4), gravity_y_4);
+
+		_mm_storeu_ps(system->age + i, age);
+
+		_mm_storeu_ps(system->velocity_x + i, velocity_x);
+
+		_mm_storeu_ps(system->velocity_y + i, velocity_y);
+
+		_mm_storeu_ps(system->position_x + i, _mm_add_ps(_mm_loadu_ps(system->position_x + i), _mm_mul_ps(velocity_x, dt_4)));
+
+		_mm_storeu_ps(system->position_y + i, _mm_add_ps(_mm_loadu_ps(system->position_y + i), _mm_mul_ps(velocity_y, dt_4)));
+
+		__m128 t = _mm_min_ps(age, one_4);
+
+		_mm_storeu_ps(system->size + i, _mm_add_ps(_mm_set1_ps(start_size), _mm_mul_ps(_mm_set1_ps(size_range), t)));
+
+		__m128i color = _mm_setzero_si128();
+
+		for (int j = 0; j < 4; j++)
+		{
+			__m128 channel = _mm_add_ps(_mm_add_ps(_mm_set1_ps(start_color[j]), _mm_mul_ps(_mm_set1_ps(color_range[j]), t)), half_4);
+
+			color = _mm_or_si128(color, _mm_sll_epi32(_mm_cvttps_epi32(channel), shift_4[j]));
+		}
+
+		_mm_storeu_si128((__m128i*)(system->color + i), color);
+	}
+
+#endif
+
+	for (; i < system->particle_count; i++)
+	{
+		system->age[i] += system->age_rate[i] * dt;
+
+		system->velocity_x[i] = system->velocity_x[i] * damping + gravity_x;
+
+		system->velocity_y[i] = system->velocity_y[i] * damping + gravity_y;
+
+		system->position_x[i] += system->velocity_x[i] * dt;
+
+		system->position_y[i] += system->velocity_y[i] * dt;
+
+		float t = fminf(system->age[i], 1.0f);
+
+		system->size[i] = start_size + size_range * t;
+
+		system->color[i] = particle_pack_color(start_color[0] + color_range[0] * t, start_color[1] + color_range[1] * t, start_color[2] + color_range[2] * t, start_color[3] + color_range[3] * t);
+	}
+
+	for (i = system->particle_count - 1; i >= 0; i--)
+	{
+		if (system->age[i] >= 1.0f)
+		{
+			particle_system_remove(system, i);
+		}
+	}
+}
+
+void particle_system_draw(Particle_System* system)
+{
+	Graphics_Vertex* vertices = system->vertices;
+
+	for (int i = 0; i < system->particle_count; i++, vertices += 6)
+	{
+		float half_size = system->size[i] * 0.5f;
+
+		float min_x = system->position_x[i] - half_size;
+
+		float min_y = system->position_y[i] - half_size;
+
+		float max_x = system->position_x[i] + half_size;
+
+		float max_y = system->position_y[i] + half_size;
+
+		unsigned int color = system->color[i];
+
+		vertices[0] = (Graphics_Vertex){ min_x, min_y, 0.0f, 0.0f, color };
+
+		vertices[1] = (Graphics_Vertex){ max_x, min_y, 1.0f, 0.0f, color };
+
+		vertices[2] = (Graphics_Vertex){ max_x, max_y, 1.0f, 1.0f, color };
+
+		vertices[3] = vertices[0];
+
+		vertices[4] = vertices[2];
+
+		vertices[5] = (Graphics_Vertex){ min_x, max_y, 0.0f, 1.0f, color };
+	}
+
+	graphics_draw_mesh(system->particle_count * 6, system->vertices);
+}
+
+void particle_system_clear(Particle_System* system)
+{
+	system->particle_count = 0;
+}
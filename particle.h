@@ -0,0 +1,54 @@
+#pragma once
+
+#include "graphics.h"
+
+typedef struct Particle_System Particle_System;
+
+struct Particle_System
+{
+	Vector gravity;
+
+	double drag;
+
+	double start_size;
+
+	double end_size;
+
+	Color start_color;
+
+	Color end_color;
+
+	int particle_count;
+
+	int particle_capacity;
+
+	float* position_x;
+
+	float* position_y;
+
+	float* velocity_x;
+
+	float* velocity_y;
+
+	float* age;
+
+	float* age_rate;
+
+	float* size;
+
+	unsigned int* color;
+
+	Graphics_Vertex* vertices;
+};
+
+Particle_System* particle_system_create(int particle_capacity);
+
+void particle_system_destroy(Particle_System* system);
+
+void particle_system_emit(Particle_System* system, Vector position, Vector velocity, double lifetime);
+
+void particle_system_update(Particle_System* system, double delta_time);
+
+void particle_system_draw(Particle_System* system);
+
+void particle_system_clear(Particle_System* system);
@@ -1,9 +1,131 @@
 #include "physics.h"
 
+#include "thread.h"
+
+typedef struct Physics_Worlds_Step Physics_Worlds_Step;
+
+typedef struct Physics_Grid_Build Physics_Grid_Build;
+
+struct Physics_Worlds_Step
+{
+	Physics_World** worlds;
+
+	double delta_time;
+};
+
+struct Physics_Grid_Build
+{
+	Physics_Grid* grid;
+
+	double cell_size;
+
+	int task_count;
+};
+
+static void physics_worlds_step_task(void* data, int index)
+{
+	Physics_Worlds_Step* step = data;
+
+	physics_world_step(step->worlds[index], step->delta_time);
+}
+
+static bool physics_grid_is_too_large(const Rect* rect, double cell_size)
+{
+	return floor(rect->max.x / cell_size) - floor(rect->min.x / cell_size) >= PHYSICS_GRID_CELL_SPAN_MAX || floor(rect->max.y / cell_size) - floor(rect->min.y / cell_size) >= PHYSICS_GRID_CELL_SPAN_MAX;
+}
+
+static void physics_grid_count_task(void* data, int index)
+{
+	Physics_Grid_Build* build = data;
+
+	Physics_Grid* grid = build->grid;
+
+	int* counts = &grid->task_bucket_offsets[index * grid->bucket_count];
+
+	memset(counts, 0, grid->bucket_count * sizeof(int));
+
+	int end = (int)((long long)grid->cell_collider_count * (index + 1) / build->task_count);
+
+	for (int i = (int)((long long)grid->cell_collider_count * index / build->task_count); i < end; i++)
+	{
+		const Rect* rect = &grid->colliders[i]->world_bounding_rect;
+
+		int min_x = physics_grid_get_cell(rect->min.x, build->cell_size);
+
+		int max_x = physics_grid_get_cell(rect->max.x, build->cell_size);
+
+		int max_y = physics_grid_get_cell(rect->max.y, build->cell_size);
+
+		for (int cell_y = physics_grid_get_cell(rect->min.y, build->cell_size); cell_y <= max_y; cell_y++)
+		{
+			for (int cell_x = min_x; cell_x <= max_x; cell_x++)
+			{
+				counts[physics_grid_get_bucket(grid, cell_x, cell_y)]++;
+			}
+		}
+	}
+}
+
+static void physics_grid_scatter_task(void* data, int index)
+{
+	Physics_Grid_Build* build = data;
+
+	Physics_Grid* grid = build->grid;
+
+	int* offsets = &grid->task_bucket_offsets[index * grid->bucket_count];
+
+	int end = (int)((long long)grid->cell_collider_count * (index + 1) / build->task_count);
+
+	for (int i = (int)((long long)grid->cell_collider_count * index / build->task_count); i < end; i++)
+	{
+		const Rect* rect = &grid->colliders[i]->world_bounding_rect;
+
+		int min_x = physics_grid_get_cell(rect->min.x, build->cell_size);
+
+		int max_x = physics_grid_get_cell(rect->max.x, build->cell_size);
+
+		int max_y = physics_grid_get_cell(rect->max.y, build->cell_size);
+
+		for (int cell_y = physics_grid_get_cell(rect->min.y, build->cell_size); cell_y <= max_y; cell_y++)
+		{
+			for (int cell_x = min_x; cell_x <= max_x; cell_x++)
+			{
+				Physics_Grid_Entry* entry = &grid->entries[offsets[physics_grid_get_bucket(grid, cell_x, cell_y)]++];
+
+				entry->collider_index = i;
+
+				entry->cell_x = cell_x;
+
+				entry->cell_y = cell_y;
+			}
+		}
+	}
+}
+
+static int physics_tree_compare_x(const void* collider_1, const void* collider_2)
+{
+	double x_1 = rect_get_center(&(*(Physics_Collider**)collider_1)->world_bounding_rect).x;
+
+	double x_2 = rect_get_center(&(*(Physics_Collider**)collider_2)->world_bounding_rect).x;
+
+	return (x_1 > x_2) - (x_1 < x_2);
+}
+
+static int physics_tree_compare_y(const void* collider_1, const void* collider_2)
+{
+	double y_1 = rect_get_center(&(*(Physics_Collider**)collider_1)->world_bounding_rect).y;
+
+	double y_2 = rect_get_center(&(*(Physics_Collider**)collider_2)->world_bounding_rect).y;
+
+	return (y_1 > y_2) - (y_1 < y_2);
+}
+
 Physics_World* physics_world_create()
 {
 	Physics_World* world = calloc(1, sizeof(Physics_World));
 
+	world->grid_cell_size = 1.0;
+
 	return world;
 }
 
@@ -27,6 +149,15 @@ void physics_world_destroy(Physics_World* world)
 		physics_collider_destroy(collider);
 	}
 
+	for (List_Node* collider_node = world->static_collider_list.first; collider_node != NULL; )
+	{
+		Physics_Collider* collider = collider_node->item;
+
+		collider_node = collider_node->next;
+
+		physics_collider_destroy(collider);
+	}
+
 	for (List_Node* joint_node = world->joint_list.first; joint_node != NULL; )
 	{
 		Physics_Joint* joint = joint_node->item;
@@ -36,6 +167,12 @@ void physics_world_destroy(Physics_World* world)
 		physics_joint_destroy(joint);
 	}
 
+	physics_tree_destroy(&world->static_tree);
+
+	physics_grid_destroy(&world->grid);
+
+	free(world->collisions);
+
 	free(world);
 }
 
@@ -45,6 +182,8 @@ void physics_world_step(Physics_World* world, double delta_time)
 	{
 		Physics_Body* body = body_node->item;
 
+		physics_body_update_world_collider_list(body);
+
 		physics_body_update_world_transform(body);
 
 		switch (body->type)
@@ -94,103 +233,33 @@ void physics_world_step(Physics_World* world, double delta_time)
 		body->correction_angular_velocity = 0.0;
 	}
 
-	for (List_Node* collider_node = world->collider_list.first; collider_node != NULL; )
-	{
-		List_Node* next = collider_node->next;
-
-		while (collider_node->prev != NULL && ((Physics_Collider*)collider_node->item)->world_bounding_rect.min.x < ((Physics_Collider*)collider_node->prev->item)->world_bounding_rect.min.x)
-		{
-			list_node_swap_with_prev(collider_node);
-		}
-
-		collider_node = next;
-	}
-
-	int collision_count_limit = imin(isquare(world->collider_list.size), PHYSICS_COLLISION_COUNT_MAX);
+	physics_world_update_static_tree(world);
 
-	Physics_Collision* collisions = malloc(collision_count_limit * sizeof(Physics_Collision));
+	world->collision_count = 0;
 
-	int collision_count = 0;
-
-	for (List_Node* collider_node_1 = world->collider_list.first; collider_node_1 != NULL; collider_node_1 = collider_node_1->next)
+	switch (world->broad_phase)
 	{
-		Physics_Collider* collider_1 = collider_node_1->item;
-
-		if (!collider_1->enabled)
+		case PHYSICS_BROAD_PHASE_SWEEP_AND_PRUNE:
 		{
-			continue;
-		}
+			physics_world_collide_sweep_and_prune(world);
 
-		for (List_Node* collider_node_2 = collider_node_1->next; collider_node_2 != NULL; collider_node_2 = collider_node_2->next)
+			break;
+		}
+		case PHYSICS_BROAD_PHASE_GRID:
 		{
-			Physics_Collider* collider_2 = collider_node_2->item;
-
-			if (!collider_2->enabled)
-			{
-				continue;
-			}
-
-			if (collider_2->world_bounding_rect.min.x > collider_1->world_bounding_rect.max.x)
-			{
-				break;
-			}
-
-			if (collider_2->world_bounding_rect.min.y > collider_1->world_bounding_rect.max.y || collider_1->world_bounding_rect.min.y > collider_2->world_bounding_rect.max.y)
-			{
-				continue;
-			}
-
-			if (collider_1->body == collider_2->body)
-			{
-				continue;
-			}
-
-			if (collider_1->body->type != PHYSICS_BODY_TYPE_DYNAMIC && collider_2->body->type != PHYSICS_BODY_TYPE_DYNAMIC)
-			{
-				continue;
-			}
-
-			if (!physics_can_collide(collider_1, collider_2))
-			{
-				continue;
-			}
-
-			bool collided = physics_collide(collider_1, collider_2, &collisions[collision_count]);
-			
-			if (collided)
-			{
-				if (world->collision_callback != NULL)
-				{
-					collided &= world->collision_callback(collider_1, collider_2);
-
-					collided &= world->collision_callback(collider_2, collider_1);
-				}
-
-				if (collider_1->collision_callback != NULL)
-				{
-					collided &= collider_1->collision_callback(collider_1, collider_2);
-				}
-
-				if (collider_2->collision_callback != NULL)
-				{
-					collided &= collider_2->collision_callback(collider_2, collider_1);
-				}
+			physics_world_collide_grid(world);
 
-				if (collided && !collider_1->sensor && !collider_2->sensor)
-				{
-					collision_count++;
-				}
-			}
+			break;
 		}
 	}
 
-	for (int i = 0; i < collision_count; i++)
+	for (int i = 0; i < world->collision_count; i++)
 	{
-		Collision collision = collisions[i].collision;
+		Collision collision = world->collisions[i].collision;
 
-		Physics_Collider* collider_1 = collisions[i].collider_1;
+		Physics_Collider* collider_1 = world->collisions[i].collider_1;
 
-		Physics_Collider* collider_2 = collisions[i].collider_2;
+		Physics_Collider* collider_2 = world->collisions[i].collider_2;
 
 		Physics_Body* body_1 = collider_1->body;
 
@@ -257,13 +326,13 @@ void physics_world_step(Physics_World* world, double delta_time)
 		body_2->angular_velocity += vector_dot(collision_tangent, tangent_2) * friction_impulse * body_2->inverse_angular_mass;
 	}
 
-	for (int i = 0; i < collision_count; i++)
+	for (int i = 0; i < world->collision_count; i++)
 	{
-		Collision collision = collisions[i].collision;
+		Collision collision = world->collisions[i].collision;
 
-		Physics_Collider* collider_1 = collisions[i].collider_1;
+		Physics_Collider* collider_1 = world->collisions[i].collider_1;
 
-		Physics_Collider* collider_2 = collisions[i].collider_2;
+		Physics_Collider* collider_2 = world->collisions[i].collider_2;
 
 		Physics_Body* body_1 = collider_1->body;
 
@@ -299,8 +368,6 @@ void physics_world_step(Physics_World* world, double delta_time)
 		physics_body_apply_correction_impulse(body_2, collision.point, vector_multiply(collision.normal, correction_impulse));
 	}
 
-	free(collisions);
-
 	for (List_Node* joint_node = world->joint_list.first; joint_node != NULL; joint_node = joint_node->next)
 	{
 		Physics_Joint* joint = joint_node->item;
@@ -425,133 +492,591 @@ void physics_world_step(Physics_World* world, double delta_time)
 	}
 }
 
-Physics_Body* physics_body_create(Physics_World* world, Physics_Body_Type type)
-{
-	Physics_Body* body = calloc(1, sizeof(Physics_Body));
-
-	body->type = type;
-
-	body->world = world;
-
-	body->node_in_world = list_insert_last_item(&world->body_list, body);
-
-	return body;
-}
-
-void physics_body_destroy(Physics_Body* body)
+void physics_worlds_step_parallel(Physics_World* worlds[], int world_count, double delta_time)
 {
-	physics_body_destroy_all_colliders(body);
-
-	physics_body_destroy_all_joints(body);
-
-	list_node_destroy(body->node_in_world);
+	Physics_Worlds_Step step = { worlds, delta_time };
 
-	free(body);
+	thread_run_parallel(physics_worlds_step_task, &step, world_count);
 }
 
-void physics_body_destroy_all_colliders(Physics_Body* body)
+void physics_world_update_static_tree(Physics_World* world)
 {
-	for (List_Node* collider_node = body->collider_list.first; collider_node != NULL; )
+	if (!world->static_tree_is_dirty)
 	{
-		Physics_Collider* collider = collider_node->item;
+		return;
+	}
 
-		collider_node = collider_node->next;
+	physics_tree_build(&world->static_tree, &world->static_collider_list);
 
-		physics_collider_destroy(collider);
-	}
+	world->static_tree_is_dirty = false;
 }
 
-void physics_body_destroy_all_joints(Physics_Body* body)
+void physics_world_collide_sweep_and_prune(Physics_World* world)
 {
-	for (List_Node* joint_node = body->joint_list.first; joint_node != NULL; )
+	for (List_Node* collider_node = world->collider_list.first; collider_node != NULL; )
 	{
-		Physics_Joint* joint = joint_node->item;
+		List_Node* next = collider_node->next;
 
-		joint_node = joint_node->next;
+		while (collider_node->prev != NULL && ((Physics_Collider*)collider_node->item)->world_bounding_rect.min.x < ((Physics_Collider*)collider_node->prev->item)->world_bounding_rect.min.x)
+		{
+			list_node_swap_with_prev(collider_node);
+		}
 
-		physics_joint_destroy(joint);
+		collider_node = next;
 	}
-}
-
-Transform physics_body_get_transform(const Physics_Body* body)
-{
-	return transform_create(body->position, body->angle);
-}
-
-Transform physics_body_get_inverse_transform(const Physics_Body* body)
-{
-	return transform_invert(transform_create(body->position, body->angle));
-}
-
-void physics_body_apply_impulse_at_local_point(Physics_Body* body, Vector local_point, Vector impulse)
-{
-	body->linear_velocity = vector_add(body->linear_velocity, vector_multiply(vector_rotate(impulse, body->angle), body->inverse_linear_mass));
-
-	body->angular_velocity += vector_cross(local_point, impulse) * body->inverse_angular_mass;
-}
 
-void physics_body_apply_impulse_at_world_point(Physics_Body* body, Vector world_point, Vector impulse)
-{
-	body->linear_velocity = vector_add(body->linear_velocity, vector_multiply(impulse, body->inverse_linear_mass));
+	for (List_Node* collider_node_1 = world->collider_list.first; collider_node_1 != NULL; collider_node_1 = collider_node_1->next)
+	{
+		Physics_Collider* collider_1 = collider_node_1->item;
 
-	body->angular_velocity += vector_cross(vector_subtract(world_point, body->position), impulse) * body->inverse_angular_mass;
-}
+		if (!collider_1->enabled)
+		{
+			continue;
+		}
 
-void physics_body_apply_force_at_local_point(Physics_Body* body, Vector local_point, Vector force)
-{
-	body->linear_force = vector_add(body->linear_force, vector_rotate(force, body->angle));
+		if (collider_1->body->type == PHYSICS_BODY_TYPE_DYNAMIC && world->static_tree.node_count > 0)
+		{
+			physics_world_collide_static_tree(world, collider_1, 0);
+		}
 
-	body->angular_force += vector_cross(local_point, force);
-}
+		for (List_Node* collider_node_2 = collider_node_1->next; collider_node_2 != NULL; collider_node_2 = collider_node_2->next)
+		{
+			Physics_Collider* collider_2 = collider_node_2->item;
 
-void physics_body_apply_force_at_world_point(Physics_Body* body, Vector world_point, Vector force)
-{
-	body->linear_force = vector_add(body->linear_force, force);
+			if (!collider_2->enabled)
+			{
+				continue;
+			}
 
-	body->angular_force += vector_cross(vector_subtract(world_point, body->position), force);
-}
+			if (collider_2->world_bounding_rect.min.x > collider_1->world_bounding_rect.max.x)
+			{
+				break;
+			}
 
-void physics_body_apply_correction_impulse(Physics_Body* body, Vector point, Vector impulse)
-{
-	body->correction_linear_velocity = vector_add(body->correction_linear_velocity, vector_multiply(impulse, body->inverse_linear_mass));
+			if (collider_2->world_bounding_rect.min.y > collider_1->world_bounding_rect.max.y || collider_1->world_bounding_rect.min.y > collider_2->world_bounding_rect.max.y)
+			{
+				continue;
+			}
 
-	body->correction_angular_velocity += vector_cross(vector_subtract(point, body->position), impulse) * body->inverse_angular_mass;
+			physics_world_collide_colliders(world, collider_1, collider_2);
+		}
+	}
 }
 
-void physics_body_update_world_transform(Physics_Body* body)
+void physics_world_collide_grid(Physics_World* world)
 {
-	if (!body->world_transform_is_dirty)
+	if (!(world->grid_cell_size > 0.0))
 	{
+		physics_world_collide_sweep_and_prune(world);
+
 		return;
 	}
 
-	Transform body_transform = physics_body_get_transform(body);
+	physics_grid_build(&world->grid, &world->collider_list, world->grid_cell_size);
 
-	for (List_Node* collider_node = body->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+	for (int i = 0; i < world->grid.collider_count; i++)
 	{
-		Physics_Collider* collider = collider_node->item;
-
-		shape_transform(collider->local_shape, body_transform, collider->world_shape);
+		Physics_Collider* collider = world->grid.colliders[i];
 
-		collider->world_bounding_rect = shape_get_bounding_rect(collider->world_shape);
+		if (collider->body->type == PHYSICS_BODY_TYPE_DYNAMIC && world->static_tree.node_count > 0)
+		{
+			physics_world_collide_static_tree(world, collider, 0);
+		}
 	}
 
-	for (List_Node* joint_node = body->joint_list.first; joint_node != NULL; joint_node = joint_node->next)
+	for (int bucket = 0; bucket < world->grid.bucket_count; bucket++)
 	{
-		Physics_Joint* joint = joint_node->item;
+		for (int i = world->grid.bucket_starts[bucket]; i < world->grid.bucket_starts[bucket + 1]; i++)
+		{
+			const Physics_Grid_Entry* entry_1 = &world->grid.entries[i];
+
+			Physics_Collider* collider_1 = world->grid.colliders[entry_1->collider_index];
+
+			for (int j = i + 1; j < world->grid.bucket_starts[bucket + 1]; j++)
+			{
+				const Physics_Grid_Entry* entry_2 = &world->grid.entries[j];
+
+				if (entry_1->cell_x != entry_2->cell_x || entry_1->cell_y != entry_2->cell_y)
+				{
+					continue;
+				}
+
+				Physics_Collider* collider_2 = world->grid.colliders[entry_2->collider_index];
+
+				if (!test_rect_rect(&collider_1->world_bounding_rect, &collider_2->world_bounding_rect))
+				{
+					continue;
+				}
+
+				Vector overlap_min = vector_create(fmax(collider_1->world_bounding_rect.min.x, collider_2->world_bounding_rect.min.x), fmax(collider_1->world_bounding_rect.min.y, collider_2->world_bounding_rect.min.y));
+
+				if (physics_grid_get_cell(overlap_min.x, world->grid_cell_size) != entry_1->cell_x || physics_grid_get_cell(overlap_min.y, world->grid_cell_size) != entry_1->cell_y)
+				{
+					continue;
+				}
+
+				physics_world_collide_colliders(world, collider_1, collider_2);
+			}
+		}
+	}
+
+	for (int i = world->grid.cell_collider_count; i < world->grid.collider_count; i++)
+	{
+		Physics_Collider* collider_2 = world->grid.colliders[i];
+
+		for (int j = 0; j < i; j++)
+		{
+			Physics_Collider* collider_1 = world->grid.colliders[j];
+
+			if (test_rect_rect(&collider_1->world_bounding_rect, &collider_2->world_bounding_rect))
+			{
+				physics_world_collide_colliders(world, collider_1, collider_2);
+			}
+		}
+	}
+}
+
+void physics_world_collide_colliders(Physics_World* world, Physics_Collider* collider_1, Physics_Collider* collider_2)
+{
+	if (collider_1->body == collider_2->body)
+	{
+		return;
+	}
+
+	if (collider_1->body->type != PHYSICS_BODY_TYPE_DYNAMIC && collider_2->body->type != PHYSICS_BODY_TYPE_DYNAMIC)
+	{
+		return;
+	}
+
+	if (!physics_can_collide(collider_1, collider_2))
+	{
+		return;
+	}
+
+	if (collider_1->sensor || collider_2->sensor)
+	{
+		if (physics_overlap(collider_1, collider_2))
+		{
+			physics_world_report_collision(world, collider_1, collider_2);
+		}
+
+		return;
+	}
+
+	if (world->collision_count == world->collision_capacity)
+	{
+		if (world->collision_capacity == PHYSICS_COLLISION_COUNT_MAX)
+		{
+			return;
+		}
+
+		world->collision_capacity = imin(imax(world->collision_capacity * 2, 64), PHYSICS_COLLISION_COUNT_MAX);
+
+		world->collisions = realloc(world->collisions, world->collision_capacity * sizeof(Physics_Collision));
+	}
+
+	if (physics_collide(collider_1, collider_2, &world->collisions[world->collision_count]))
+	{
+		if (physics_world_report_collision(world, collider_1, collider_2))
+		{
+			world->collision_count++;
+		}
+	}
+}
+
+bool physics_world_report_collision(Physics_World* world, Physics_Collider* collider_1, Physics_Collider* collider_2)
+{
+	bool collided = true;
+
+	if (world->collision_callback != NULL)
+	{
+		collided &= world->collision_callback(collider_1, collider_2);
+
+		collided &= world->collision_callback(collider_2, collider_1);
+	}
+
+	if (collider_1->collision_callback != NULL)
+	{
+		collided &= collider_1->collision_callback(collider_1, collider_2);
+	}
+
+	if (collider_2->collision_callback != NULL)
+	{
+		collided &= collider_2->collision_callback(collider_2, collider_1);
+	}
+
+	return collided;
+}
+
+void physics_world_collide_static_tree(Physics_World* world, Physics_Collider* collider, int node_index)
+{
+	const Physics_Tree_Node* node = &world->static_tree.nodes[node_index];
+
+	if (!test_rect_rect(&node->rect, &collider->world_bounding_rect))
+	{
+		return;
+	}
+
+	if (node->collider != NULL)
+	{
+		if (node->collider->enabled)
+		{
+			physics_world_collide_colliders(world, collider, node->collider);
+		}
+
+		return;
+	}
+
+	physics_world_collide_static_tree(world, collider, node->child_1);
+
+	physics_world_collide_static_tree(world, collider, node->child_2);
+}
+
+void physics_world_update_world_transforms(Physics_World* world)
+{
+	for (List_Node* body_node = world->body_list.first; body_node != NULL; body_node = body_node->next)
+	{
+		Physics_Body* body = body_node->item;
+
+		physics_body_update_world_collider_list(body);
+
+		physics_body_update_world_transform(body);
+	}
+
+	physics_world_update_static_tree(world);
+}
+
+Physics_Collider* physics_world_raycast(Physics_World* world, const Ray* ray, Ray_Hit* hit)
+{
+	physics_world_update_world_transforms(world);
+
+	Physics_Collider* collider = NULL;
+
+	hit->fraction = 1.0;
+
+	if (world->static_tree.node_count > 0)
+	{
+		physics_world_raycast_static_tree(world, ray, 0, hit, &collider);
+	}
+
+	for (List_Node* collider_node = world->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+	{
+		Physics_Collider* other = collider_node->item;
+
+		if (!test_ray_rect(ray, hit->fraction, &other->world_bounding_rect))
+		{
+			continue;
+		}
+
+		Ray_Hit other_hit;
+
+		if (physics_collider_raycast(other, ray, &other_hit) && other_hit.fraction < hit->fraction)
+		{
+			*hit = other_hit;
+
+			collider = other;
+		}
+	}
+
+	return collider;
+}
+
+void physics_world_raycast_static_tree(Physics_World* world, const Ray* ray, int node_index, Ray_Hit* hit, Physics_Collider** collider)
+{
+	const Physics_Tree_Node* node = &world->static_tree.nodes[node_index];
+
+	if (!test_ray_rect(ray, hit->fraction, &node->rect))
+	{
+		return;
+	}
+
+	if (node->collider != NULL)
+	{
+		Ray_Hit other_hit;
+
+		if (physics_collider_raycast(node->collider, ray, &other_hit) && other_hit.fraction < hit->fraction)
+		{
+			*hit = other_hit;
+
+			*collider = node->collider;
+		}
+
+		return;
+	}
+
+	physics_world_raycast_static_tree(world, ray, node->child_1, hit, collider);
+
+	physics_world_raycast_static_tree(world, ray, node->child_2, hit, collider);
+}
+
+void physics_world_raycast_packet(Physics_World* world, const Ray_Packet* packet, Ray_Packet_Hit* hit, Physics_Collider* colliders[RAY_PACKET_SIZE])
+{
+	physics_world_update_world_transforms(world);
+
+	for (int i = 0; i < RAY_PACKET_SIZE; i++)
+	{
+		hit->fraction[i] = 1.0;
+
+		colliders[i] = NULL;
+	}
+
+	Rect packet_rect = ray_packet_get_bounding_rect(packet, hit);
+
+	if (world->static_tree.node_count > 0)
+	{
+		physics_world_raycast_packet_static_tree(world, packet, &packet_rect, 0, hit, colliders);
+
+		packet_rect = ray_packet_get_bounding_rect(packet, hit);
+	}
+
+	for (List_Node* collider_node = world->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+	{
+		Physics_Collider* collider = collider_node->item;
+
+		if (test_rect_rect(&packet_rect, &collider->world_bounding_rect))
+		{
+			physics_collider_raycast_packet(collider, packet, hit, colliders);
+		}
+	}
+}
+
+void physics_world_raycast_packet_static_tree(Physics_World* world, const Ray_Packet* packet, const Rect* packet_rect, int node_index, Ray_Packet_Hit* hit, Physics_Collider* colliders[RAY_PACKET_SIZE])
+{
+	const Physics_Tree_Node* node = &world->static_tree.nodes[node_index];
+
+	if (!test_rect_rect(&node->rect, packet_rect))
+	{
+		return;
+	}
+
+	if (node->collider != NULL)
+	{
+		physics_collider_raycast_packet(node->collider, packet, hit, colliders);
+
+		return;
+	}
+
+	physics_world_raycast_packet_static_tree(world, packet, packet_rect, node->child_1, hit, colliders);
+
+	physics_world_raycast_packet_static_tree(world, packet, packet_rect, node->child_2, hit, colliders);
+}
+
+Physics_Body* physics_body_create(Physics_World* world, Physics_Body_Type type)
+{
+	Physics_Body* body = calloc(1, sizeof(Physics_Body));
+
+	body->type = type;
+
+	body->world = world;
+
+	body->node_in_world = list_insert_last_item(&world->body_list, body);
+
+	return body;
+}
+
+void physics_body_destroy(Physics_Body* body)
+{
+	physics_body_destroy_all_colliders(body);
+
+	physics_body_destroy_all_joints(body);
+
+	list_node_destroy(body->node_in_world);
+
+	free(body);
+}
+
+void physics_body_destroy_all_colliders(Physics_Body* body)
+{
+	for (List_Node* collider_node = body->collider_list.first; collider_node != NULL; )
+	{
+		Physics_Collider* collider = collider_node->item;
+
+		collider_node = collider_node->next;
+
+		physics_collider_destroy(collider);
+	}
+}
+
+void physics_body_destroy_all_joints(Physics_Body* body)
+{
+	for (List_Node* joint_node = body->joint_list.first; joint_node != NULL; )
+	{
+		Physics_Joint* joint = joint_node->item;
+
+		joint_node = joint_node->next;
+
+		physics_joint_destroy(joint);
+	}
+}
+
+Transform physics_body_get_transform(const Physics_Body* body)
+{
+	return transform_create(body->position, body->angle);
+}
+
+Transform physics_body_get_inverse_transform(const Physics_Body* body)
+{
+	return transform_invert(transform_create(body->position, body->angle));
+}
+
+void physics_body_apply_impulse_at_local_point(Physics_Body* body, Vector local_point, Vector impulse)
+{
+	body->linear_velocity = vector_add(body->linear_velocity, vector_multiply(vector_rotate(impulse, body->angle), body->inverse_linear_mass));
+
+	body->angular_velocity += vector_cross(local_point, impulse) * body->inverse_angular_mass;
+}
+
+void physics_body_apply_impulse_at_world_point(Physics_Body* body, Vector world_point, Vector impulse)
+{
+	body->linear_velocity = vector_add(body->linear_velocity, vector_multiply(impulse, body->inverse_linear_mass));
+
+	body->angular_velocity += vector_cross(vector_subtract(world_point, body->position), impulse) * body->inverse_angular_mass;
+}
+
+void physics_body_apply_force_at_local_point(Physics_Body* body, Vector local_point, Vector force)
+{
+	body->linear_force = vector_add(body->linear_force, vector_rotate(force, body->angle));
+
+	body->angular_force += vector_cross(local_point, force);
+}
+
+void physics_body_apply_force_at_world_point(Physics_Body* body, Vector world_point, Vector force)
+{
+	body->linear_force = vector_add(body->linear_force, force);
+
+	body->angular_force += vector_cross(vector_subtract(world_point, body->position), force);
+}
+
+void physics_body_apply_correction_impulse(Physics_Body* body, Vector point, Vector impulse)
+{
+	body->correction_linear_velocity = vector_add(body->correction_linear_velocity, vector_multiply(impulse, body->inverse_linear_mass));
+
+	body->correction_angular_velocity += vector_cross(vector_subtract(point, body->position), impulse) * body->inverse_angular_mass;
+}
+
+void physics_body_update_world_transform(Physics_Body* body)
+{
+	if (!body->world_transform_is_dirty)
+	{
+		return;
+	}
+
+	Transform body_transform = physics_body_get_transform(body);
+
+	body->world_transform = body_transform;
+
+	for (List_Node* collider_node = body->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+	{
+		Physics_Collider* collider = collider_node->item;
+
+		physics_collider_update_world_bounding_rect(collider);
+
+		collider->cached_world_shape_is_dirty = true;
+	}
+
+	for (List_Node* joint_node = body->joint_list.first; joint_node != NULL; joint_node = joint_node->next)
+	{
+		Physics_Joint* joint = joint_node->item;
+
+		if (joint->body_1 == body)
+		{
+			joint->world_anchor_1 = transform_apply(body_transform, joint->local_anchor_1);
+		}
+
+		if (joint->body_2 == body)
+		{
+			joint->world_anchor_2 = transform_apply(body_transform, joint->local_anchor_2);
+		}
+	}
+
+	if (body->type == PHYSICS_BODY_TYPE_STATIC)
+	{
+		body->world->static_tree_is_dirty = true;
+	}
+
+	body->world_transform_is_dirty = false;
+}
+
+void physics_body_update_world_collider_list(Physics_Body* body)
+{
+	if (body->collider_list.first == NULL)
+	{
+		return;
+	}
+
+	List* world_collider_list = body->type == PHYSICS_BODY_TYPE_STATIC ? &body->world->static_collider_list : &body->world->collider_list;
+
+	if (((Physics_Collider*)body->collider_list.first->item)->node_in_world->list == world_collider_list)
+	{
+		return;
+	}
 
-		if (joint->body_1 == body)
-		{
-			joint->world_anchor_1 = transform_apply(body_transform, joint->local_anchor_1);
-		}
+	for (List_Node* collider_node = body->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+	{
+		Physics_Collider* collider = collider_node->item;
 
-		if (joint->body_2 == body)
-		{
-			joint->world_anchor_2 = transform_apply(body_transform, joint->local_anchor_2);
-		}
+		list_node_remove(collider->node_in_world);
+
+		list_insert_last(world_collider_list, collider->node_in_world);
 	}
 
-	body->world_transform_is_dirty = false;
+	body->world->static_tree_is_dirty = true;
+}
+
+void physics_body_update_mass(Physics_Body* body)
+{
+	Vector weighted_center_of_mass = vector_create(0.0, 0.0);
+
+	double body_linear_mass = 0.0;
+
+	for (const List_Node* collider_node = body->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+	{
+		Vector collider_center_of_mass;
+
+		double collider_linear_mass;
+
+		double collider_angular_mass;
+
+		physics_collider_get_mass(collider_node->item, &collider_center_of_mass, &collider_linear_mass, &collider_angular_mass);
+
+		weighted_center_of_mass = vector_add(weighted_center_of_mass, vector_multiply(collider_center_of_mass, collider_linear_mass));
+
+		body_linear_mass += collider_linear_mass;
+	}
+
+	if (body_linear_mass == 0.0)
+	{
+		body->center_of_mass = vector_create(0.0, 0.0);
+
+		body->real_inverse_linear_mass = 0.0;
+
+		body->real_inverse_angular_mass = 0.0;
+
+		return;
+	}
+
+	Vector body_center_of_mass = vector_divide(weighted_center_of_mass, body_linear_mass);
+
+	double body_angular_mass = 0.0;
+
+	for (const List_Node* collider_node = body->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+	{
+		Vector collider_center_of_mass;
+
+		double collider_linear_mass;
+
+		double collider_angular_mass;
+
+		physics_collider_get_mass(collider_node->item, &collider_center_of_mass, &collider_linear_mass, &collider_angular_mass);
+
+		body_angular_mass += collider_angular_mass + collider_linear_mass * vector_distance_squared(collider_center_of_mass, body_center_of_mass);
+	}
+
+	body->center_of_mass = body_center_of_mass;
+
+	body->real_inverse_linear_mass = 1.0 / body_linear_mass;
+
+	body->real_inverse_angular_mass = 1.0 / body_angular_mass;
 }
 
 void physics_body_add_collider_mass(Physics_Body* body, Physics_Collider* collider)
@@ -625,13 +1150,89 @@ void physics_body_subtract_collider_mass(Physics_Body* body, Physics_Collider* c
 
 Physics_Collider* physics_collider_create(Physics_Body* body, const Shape* shape, double density)
 {
-	Physics_Collider* collider = calloc(1, sizeof(Physics_Collider));
+	Physics_Collider* collider = physics_collider_allocate(body, shape);
+
+	collider->density = density;
+
+	physics_body_add_collider_mass(body, collider);
+
+	return collider;
+}
+
+void physics_colliders_create(int definition_count, const Physics_Collider_Definition definitions[], Physics_Collider* colliders[])
+{
+	for (int i = 0; i < definition_count; i++)
+	{
+		const Physics_Collider_Definition* definition = &definitions[i];
 
-	collider->local_shape = shape_clone(shape);
+		Physics_Collider* collider = physics_collider_allocate(definition->body, definition->shape);
 
-	collider->world_shape = shape_clone(shape);
+		collider->density = definition->density;
 
-	collider->density = density;
+		collider->restitution = definition->restitution;
+
+		collider->static_friction = definition->static_friction;
+
+		collider->dynamic_friction = definition->dynamic_friction;
+
+		collider->filter_mask_1 = definition->filter_mask_1;
+
+		collider->filter_mask_2 = definition->filter_mask_2;
+
+		collider->filter_group = definition->filter_group;
+
+		collider->sensor = definition->sensor;
+
+		if (colliders != NULL)
+		{
+			colliders[i] = collider;
+		}
+
+		if (i + 1 == definition_count || definitions[i + 1].body != definition->body)
+		{
+			physics_body_update_mass(definition->body);
+		}
+	}
+}
+
+Physics_Collider_Definition physics_collider_definition_create(Physics_Body* body, const Shape* shape, double density)
+{
+	Physics_Collider_Definition definition = { 0 };
+
+	definition.body = body;
+
+	definition.shape = shape;
+
+	definition.density = density;
+
+	definition.filter_mask_1 = 0xFFFFFFFF;
+
+	definition.filter_mask_2 = 0xFFFFFFFF;
+
+	return definition;
+}
+
+Physics_Collider* physics_collider_allocate(Physics_Body* body, const Shape* shape)
+{
+	size_t shape_size = shape_get_size(shape);
+
+	char* memory = calloc(1, sizeof(Physics_Collider) + sizeof(List_Node) * 2 + shape_size * 2);
+
+	Physics_Collider* collider = (Physics_Collider*)memory;
+
+	List_Node* nodes = (List_Node*)(memory + sizeof(Physics_Collider));
+
+	collider->local_shape = (Shape*)(memory + sizeof(Physics_Collider) + sizeof(List_Node) * 2);
+
+	collider->cached_world_shape = (Shape*)(memory + sizeof(Physics_Collider) + sizeof(List_Node) * 2 + shape_size);
+
+	memcpy(collider->local_shape, shape, shape_size);
+
+	memcpy(collider->cached_world_shape, shape, shape_size);
+
+	collider->local_bounding_rect = shape_get_bounding_rect(shape);
+
+	collider->local_bounding_radius = shape_get_bounding_radius(shape, rect_get_center(&collider->local_bounding_rect));
 
 	collider->filter_mask_1 = 0xFFFFFFFF;
 
@@ -643,11 +1244,24 @@ Physics_Collider* physics_collider_create(Physics_Body* body, const Shape* shape
 
 	collider->body = body;
 
-	collider->node_in_body = list_insert_last_item(&body->collider_list, collider);
+	collider->node_in_body = &nodes[0];
 
-	collider->node_in_world = list_insert_last_item(&body->world->collider_list, collider);
+	collider->node_in_body->item = collider;
 
-	physics_body_add_collider_mass(body, collider);
+	list_insert_last(&body->collider_list, collider->node_in_body);
+
+	collider->node_in_world = &nodes[1];
+
+	collider->node_in_world->item = collider;
+
+	if (body->type == PHYSICS_BODY_TYPE_STATIC)
+	{
+		list_insert_last(&body->world->static_collider_list, collider->node_in_world);
+	}
+	else
+	{
+		list_insert_last(&body->world->collider_list, collider->node_in_world);
+	}
 
 	body->world_transform_is_dirty = true;
 
@@ -660,17 +1274,82 @@ void physics_collider_destroy(Physics_Collider* collider)
 
 	physics_body_subtract_collider_mass(body, collider);
 
-	shape_destroy(collider->local_shape);
-
-	shape_destroy(collider->world_shape);
+	if (collider->node_in_world->list == &body->world->static_collider_list)
+	{
+		body->world->static_tree_is_dirty = true;
+	}
 
-	list_node_destroy(collider->node_in_body);
+	list_node_remove(collider->node_in_body);
 
-	list_node_destroy(collider->node_in_world);
+	list_node_remove(collider->node_in_world);
 
 	free(collider);
 }
 
+void physics_collider_update_world_shape(Physics_Collider* collider)
+{
+	if (!collider->cached_world_shape_is_dirty)
+	{
+		return;
+	}
+
+	shape_transform(collider->local_shape, collider->body->world_transform, collider->cached_world_shape);
+
+	collider->cached_world_shape_is_dirty = false;
+}
+
+void physics_collider_update_world_bounding_rect(Physics_Collider* collider)
+{
+	Rect rect = rect_transform(&collider->local_bounding_rect, collider->body->world_transform);
+
+	Vector center = rect_get_center(&rect);
+
+	Vector extent = vector_create(fmin(rect.max.x - center.x, collider->local_bounding_radius), fmin(rect.max.y - center.y, collider->local_bounding_radius));
+
+	collider->world_bounding_rect.min = vector_subtract(center, extent);
+
+	collider->world_bounding_rect.max = vector_add(center, extent);
+}
+
+const Shape* physics_collider_get_world_shape(Physics_Collider* collider)
+{
+	physics_collider_update_world_shape(collider);
+
+	return collider->cached_world_shape;
+}
+
+bool physics_collider_raycast(Physics_Collider* collider, const Ray* ray, Ray_Hit* hit)
+{
+	if (!collider->enabled || collider->sensor)
+	{
+		return false;
+	}
+
+	return raycast_shape(physics_collider_get_world_shape(collider), ray, hit);
+}
+
+void physics_collider_raycast_packet(Physics_Collider* collider, const Ray_Packet* packet, Ray_Packet_Hit* hit, Physics_Collider* colliders[RAY_PACKET_SIZE])
+{
+	if (!collider->enabled || collider->sensor)
+	{
+		return;
+	}
+
+	double fractions[RAY_PACKET_SIZE];
+
+	memcpy(fractions, hit->fraction, sizeof(fractions));
+
+	raycast_shape_packet(physics_collider_get_world_shape(collider), packet, hit);
+
+	for (int i = 0; i < RAY_PACKET_SIZE; i++)
+	{
+		if (hit->fraction[i] < fractions[i])
+		{
+			colliders[i] = collider;
+		}
+	}
+}
+
 void physics_collider_get_mass(const Physics_Collider* collider, Vector* center_of_mass, double* linear_mass, double* angular_mass)
 {
 	*center_of_mass = shape_get_centroid(collider->local_shape);
@@ -736,6 +1415,193 @@ void physics_joint_destroy(Physics_Joint* joint)
 	free(joint);
 }
 
+void physics_tree_build(Physics_Tree* tree, const List* collider_list)
+{
+	physics_tree_destroy(tree);
+
+	if (collider_list->size == 0)
+	{
+		return;
+	}
+
+	Physics_Collider** colliders = malloc(collider_list->size * sizeof(Physics_Collider*));
+
+	int collider_count = 0;
+
+	for (const List_Node* collider_node = collider_list->first; collider_node != NULL; collider_node = collider_node->next)
+	{
+		colliders[collider_count++] = collider_node->item;
+	}
+
+	tree->nodes = malloc((collider_count * 2 - 1) * sizeof(Physics_Tree_Node));
+
+	physics_tree_build_node(tree, colliders, collider_count);
+
+	free(colliders);
+}
+
+int physics_tree_build_node(Physics_Tree* tree, Physics_Collider* colliders[], int collider_count)
+{
+	int node_index = tree->node_count++;
+
+	Physics_Tree_Node* node = &tree->nodes[node_index];
+
+	if (collider_count == 1)
+	{
+		node->rect = colliders[0]->world_bounding_rect;
+
+		node->child_1 = -1;
+
+		node->child_2 = -1;
+
+		node->collider = colliders[0];
+
+		return node_index;
+	}
+
+	Rect rect = colliders[0]->world_bounding_rect;
+
+	for (int i = 1; i < collider_count; i++)
+	{
+		rect = rect_merge(&rect, &colliders[i]->world_bounding_rect);
+	}
+
+	qsort(colliders, collider_count, sizeof(Physics_Collider*), rect.max.x - rect.min.x > rect.max.y - rect.min.y ? physics_tree_compare_x : physics_tree_compare_y);
+
+	node->rect = rect;
+
+	node->collider = NULL;
+
+	node->child_1 = physics_tree_build_node(tree, colliders, collider_count / 2);
+
+	node->child_2 = physics_tree_build_node(tree, colliders + collider_count / 2, collider_count - collider_count / 2);
+
+	return node_index;
+}
+
+void physics_tree_destroy(Physics_Tree* tree)
+{
+	free(tree->nodes);
+
+	tree->nodes = NULL;
+
+	tree->node_count = 0;
+}
+
+void physics_grid_build(Physics_Grid* grid, const List* collider_list, double cell_size)
+{
+	if (grid->collider_capacity < collider_list->size)
+	{
+		grid->collider_capacity = collider_list->size;
+
+		grid->colliders = realloc(grid->colliders, grid->collider_capacity * sizeof(Physics_Collider*));
+	}
+
+	grid->cell_collider_count = 0;
+
+	int large_collider_count = 0;
+
+	for (const List_Node* collider_node = collider_list->first; collider_node != NULL; collider_node = collider_node->next)
+	{
+		Physics_Collider* collider = collider_node->item;
+
+		if (!collider->enabled)
+		{
+			continue;
+		}
+
+		if (physics_grid_is_too_large(&collider->world_bounding_rect, cell_size))
+		{
+			grid->colliders[grid->collider_capacity - ++large_collider_count] = collider;
+		}
+		else
+		{
+			grid->colliders[grid->cell_collider_count++] = collider;
+		}
+	}
+
+	memmove(&grid->colliders[grid->cell_collider_count], &grid->colliders[grid->collider_capacity - large_collider_count], large_collider_count * sizeof(Physics_Collider*));
+
+	grid->collider_count = grid->cell_collider_count + large_collider_count;
+
+	int bucket_count = 1;
+
+	while (bucket_count < grid->cell_collider_count * 2)
+	{
+		bucket_count *= 2;
+	}
+
+	if (grid->bucket_count != bucket_count)
+	{
+		grid->bucket_count = bucket_count;
+
+		grid->bucket_starts = realloc(grid->bucket_starts, (grid->bucket_count + 1) * sizeof(int));
+	}
+
+	Physics_Grid_Build build = { grid, cell_size, imax(imin(thread_get_processor_count(), grid->cell_collider_count / PHYSICS_GRID_TASK_COLLIDER_COUNT_MIN), 1) };
+
+	if (grid->task_bucket_capacity < build.task_count * bucket_count)
+	{
+		grid->task_bucket_capacity = build.task_count * bucket_count;
+
+		grid->task_bucket_offsets = realloc(grid->task_bucket_offsets, grid->task_bucket_capacity * sizeof(int));
+	}
+
+	thread_run_parallel(physics_grid_count_task, &build, build.task_count);
+
+	int entry_count = 0;
+
+	for (int bucket = 0; bucket < bucket_count; bucket++)
+	{
+		grid->bucket_starts[bucket] = entry_count;
+
+		for (int task = 0; task < build.task_count; task++)
+		{
+			int count = grid->task_bucket_offsets[task * bucket_count + bucket];
+
+			grid->task_bucket_offsets[task * bucket_count + bucket] = entry_count;
+
+			entry_count += count;
+		}
+	}
+
+	grid->bucket_starts[bucket_count] = entry_count;
+
+	if (grid->entry_capacity < entry_count)
+	{
+		grid->entry_capacity = entry_count;
+
+		grid->entries = realloc(grid->entries, grid->entry_capacity * sizeof(Physics_Grid_Entry));
+	}
+
+	grid->entry_count = entry_count;
+
+	thread_run_parallel(physics_grid_scatter_task, &build, build.task_count);
+}
+
+int physics_grid_get_cell(double coordinate, double cell_size)
+{
+	return (int)fmin(fmax(floor(coordinate / cell_size), -PHYSICS_GRID_CELL_MAX), PHYSICS_GRID_CELL_MAX);
+}
+
+int physics_grid_get_bucket(const Physics_Grid* grid, int cell_x, int cell_y)
+{
+	return (int)(((unsigned int)cell_x * 73856093u ^ (unsigned int)cell_y * 19349663u) & (unsigned int)(grid->bucket_count - 1));
+}
+
+void physics_grid_destroy(Physics_Grid* grid)
+{
+	free(grid->colliders);
+
+	free(grid->entries);
+
+	free(grid->bucket_starts);
+
+	free(grid->task_bucket_offsets);
+
+	memset(grid, 0, sizeof(Physics_Grid));
+}
+
 bool physics_can_collide(const Physics_Collider* collider_1, const Physics_Collider* collider_2)
 {
 	if (collider_1->filter_group == collider_2->filter_group)
@@ -754,9 +1620,19 @@ bool physics_can_collide(const Physics_Collider* collider_1, const Physics_Colli
 	return (collider_1->filter_mask_1 & collider_2->filter_mask_2) != 0 && (collider_1->filter_mask_2 & collider_2->filter_mask_1) != 0;
 }
 
-bool physics_collide(const Physics_Collider* collider_1, const Physics_Collider* collider_2, Physics_Collision* collision)
+bool physics_overlap(Physics_Collider* collider_1, Physics_Collider* collider_2)
+{
+	return overlap_shapes(physics_collider_get_world_shape(collider_1), physics_collider_get_world_shape(collider_2));
+}
+
+double physics_distance(Physics_Collider* collider_1, Physics_Collider* collider_2, Vector* closest_1, Vector* closest_2)
+{
+	return shape_distance(physics_collider_get_world_shape(collider_1), physics_collider_get_world_shape(collider_2), closest_1, closest_2);
+}
+
+bool physics_collide(Physics_Collider* collider_1, Physics_Collider* collider_2, Physics_Collision* collision)
 {
-	if (collide_shapes(collider_1->world_shape, collider_2->world_shape, &collision->collision))
+	if (collide_shapes(physics_collider_get_world_shape(collider_1), physics_collider_get_world_shape(collider_2), &collision->collision))
 	{
 		collision->collider_1 = (Physics_Collider*)collider_1;
 
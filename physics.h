@@ -8,22 +8,49 @@
 
 #define PHYSICS_CORRECTION_VELOCITY_GAIN 0.1
 
+#define PHYSICS_GRID_CELL_MAX 1000000000
+
+#define PHYSICS_GRID_CELL_SPAN_MAX 4
+
+#define PHYSICS_GRID_TASK_COLLIDER_COUNT_MIN 4096
+
+typedef enum Physics_Broad_Phase Physics_Broad_Phase;
+
 typedef enum Physics_Body_Type Physics_Body_Type;
 
 typedef enum Physics_Joint_Type Physics_Joint_Type;
 
+typedef struct Physics_Tree Physics_Tree;
+
+typedef struct Physics_Tree_Node Physics_Tree_Node;
+
+typedef struct Physics_Grid Physics_Grid;
+
+typedef struct Physics_Grid_Entry Physics_Grid_Entry;
+
 typedef struct Physics_World Physics_World;
 
 typedef struct Physics_Body Physics_Body;
 
 typedef struct Physics_Collider Physics_Collider;
 
+typedef struct Physics_Collider_Definition Physics_Collider_Definition;
+
 typedef struct Physics_Joint Physics_Joint;
 
 typedef struct Physics_Collision Physics_Collision;
 
 typedef bool (* Physics_Collision_Callback)(Physics_Collider* collider, Physics_Collider* other);
 
+enum Physics_Broad_Phase
+{
+	PHYSICS_BROAD_PHASE_SWEEP_AND_PRUNE,
+
+	PHYSICS_BROAD_PHASE_GRID,
+
+	PHYSICS_BROAD_PHASE_COUNT
+};
+
 enum Physics_Body_Type
 {
 	PHYSICS_BODY_TYPE_DYNAMIC,
@@ -44,6 +71,58 @@ enum Physics_Joint_Type
 	PHYSICS_JOINT_TYPE_COUNT
 };
 
+struct Physics_Tree
+{
+	Physics_Tree_Node* nodes;
+
+	int node_count;
+};
+
+struct Physics_Tree_Node
+{
+	Rect rect;
+
+	int child_1;
+
+	int child_2;
+
+	Physics_Collider* collider;
+};
+
+struct Physics_Grid
+{
+	Physics_Collider** colliders;
+
+	int collider_count;
+
+	int collider_capacity;
+
+	int cell_collider_count;
+
+	Physics_Grid_Entry* entries;
+
+	int entry_count;
+
+	int entry_capacity;
+
+	int* bucket_starts;
+
+	int bucket_count;
+
+	int* task_bucket_offsets;
+
+	int task_bucket_capacity;
+};
+
+struct Physics_Grid_Entry
+{
+	int collider_index;
+
+	int cell_x;
+
+	int cell_y;
+};
+
 struct Physics_World
 {
 	Vector gravity;
@@ -52,8 +131,26 @@ struct Physics_World
 
 	List collider_list;
 
+	List static_collider_list;
+
 	List joint_list;
 
+	Physics_Tree static_tree;
+
+	bool static_tree_is_dirty;
+
+	Physics_Broad_Phase broad_phase;
+
+	double grid_cell_size;
+
+	Physics_Grid grid;
+
+	Physics_Collision* collisions;
+
+	int collision_count;
+
+	int collision_capacity;
+
 	Physics_Collision_Callback collision_callback;
 };
 
@@ -87,6 +184,8 @@ struct Physics_Body
 
 	double correction_angular_velocity;
 
+	Transform world_transform;
+
 	bool world_transform_is_dirty;
 
 	List collider_list;
@@ -102,10 +201,16 @@ struct Physics_Collider
 {
 	Shape* local_shape;
 
-	Shape* world_shape;
+	Shape* cached_world_shape;
+
+	Rect local_bounding_rect;
+
+	double local_bounding_radius;
 
 	Rect world_bounding_rect;
 
+	bool cached_world_shape_is_dirty;
+
 	double density;
 
 	double restitution;
@@ -135,6 +240,29 @@ struct Physics_Collider
 	void* data;
 };
 
+struct Physics_Collider_Definition
+{
+	Physics_Body* body;
+
+	const Shape* shape;
+
+	double density;
+
+	double restitution;
+
+	double static_friction;
+
+	double dynamic_friction;
+
+	int filter_mask_1;
+
+	int filter_mask_2;
+
+	int filter_group;
+
+	bool sensor;
+};
+
 struct Physics_Joint
 {
 	Physics_Joint_Type type;
@@ -173,6 +301,30 @@ void physics_world_destroy(Physics_World* world);
 
 void physics_world_step(Physics_World* world, double delta_time);
 
+void physics_worlds_step_parallel(Physics_World* worlds[], int world_count, double delta_time);
+
+void physics_world_update_static_tree(Physics_World* world);
+
+void physics_world_collide_sweep_and_prune(Physics_World* world);
+
+void physics_world_collide_grid(Physics_World* world);
+
+void physics_world_collide_colliders(Physics_World* world, Physics_Collider* collider_1, Physics_Collider* collider_2);
+
+bool physics_world_report_collision(Physics_World* world, Physics_Collider* collider_1, Physics_Collider* collider_2);
+
+void physics_world_collide_static_tree(Physics_World* world, Physics_Collider* collider, int node_index);
+
+void physics_world_update_world_transforms(Physics_World* world);
+
+Physics_Collider* physics_world_raycast(Physics_World* world, const Ray* ray, Ray_Hit* hit);
+
+void physics_world_raycast_static_tree(Physics_World* world, const Ray* ray, int node_index, Ray_Hit* hit, Physics_Collider** collider);
+
+void physics_world_raycast_packet(Physics_World* world, const Ray_Packet* packet, Ray_Packet_Hit* hit, Physics_Collider* colliders[RAY_PACKET_SIZE]);
+
+void physics_world_raycast_packet_static_tree(Physics_World* world, const Ray_Packet* packet, const Rect* packet_rect, int node_index, Ray_Packet_Hit* hit, Physics_Collider* colliders[RAY_PACKET_SIZE]);
+
 Physics_Body* physics_body_create(Physics_World* world, Physics_Body_Type type);
 
 void physics_body_destroy(Physics_Body* body);
@@ -197,16 +349,36 @@ void physics_body_apply_correction_impulse(Physics_Body* body, Vector point, Vec
 
 void physics_body_update_world_transform(Physics_Body* body);
 
+void physics_body_update_world_collider_list(Physics_Body* body);
+
+void physics_body_update_mass(Physics_Body* body);
+
 void physics_body_add_collider_mass(Physics_Body* body, Physics_Collider* collider);
 
 void physics_body_subtract_collider_mass(Physics_Body* body, Physics_Collider* collider);
 
 Physics_Collider* physics_collider_create(Physics_Body* body, const Shape* shape, double density);
 
+void physics_colliders_create(int definition_count, const Physics_Collider_Definition definitions[], Physics_Collider* colliders[]);
+
+Physics_Collider_Definition physics_collider_definition_create(Physics_Body* body, const Shape* shape, double density);
+
+Physics_Collider* physics_collider_allocate(Physics_Body* body, const Shape* shape);
+
 void physics_collider_destroy(Physics_Collider* collider);
 
+void physics_collider_update_world_shape(Physics_Collider* collider);
+
+void physics_collider_update_world_bounding_rect(Physics_Collider* collider);
+
+const Shape* physics_collider_get_world_shape(Physics_Collider* collider);
+
 void physics_collider_get_mass(const Physics_Collider* collider, Vector* center_of_mass, double* linear_mass, double* angular_mass);
 
+bool physics_collider_raycast(Physics_Collider* collider, const Ray* ray, Ray_Hit* hit);
+
+void physics_collider_raycast_packet(Physics_Collider* collider, const Ray_Packet* packet, Ray_Packet_Hit* hit, Physics_Collider* colliders[RAY_PACKET_SIZE]);
+
 Physics_Joint* physics_joint_create(Physics_Joint_Type type, Physics_Body* body_1, Vector local_anchor_1, Vector world_anchor_1, Physics_Body* body_2, Vector local_anchor_2, Vector world_anchor_2);
 
 Physics_Joint* physics_joint_create_local(Physics_Joint_Type type, Physics_Body* body_1, Vector local_anchor_1, Physics_Body* body_2, Vector local_anchor_2);
@@ -215,7 +387,25 @@ Physics_Joint* physics_joint_create_world(Physics_Joint_Type type, Physics_Body*
 
 void physics_joint_destroy(Physics_Joint* joint);
 
+void physics_tree_build(Physics_Tree* tree, const List* collider_list);
+
+int physics_tree_build_node(Physics_Tree* tree, Physics_Collider* colliders[], int collider_count);
+
+void physics_tree_destroy(Physics_Tree* tree);
+
+void physics_grid_build(Physics_Grid* grid, const List* collider_list, double cell_size);
+
+int physics_grid_get_cell(double coordinate, double cell_size);
+
+int physics_grid_get_bucket(const Physics_Grid* grid, int cell_x, int cell_y);
+
+void physics_grid_destroy(Physics_Grid* grid);
+
 bool physics_can_collide(const Physics_Collider* collider_1, const Physics_Collider* collider_2);
 
-bool physics_collide(const Physics_Collider* collider_1, const Physics_Collider* collider_2, Physics_Collision* collision);
+bool physics_overlap(Physics_Collider* collider_1, Physics_Collider* collider_2);
+
+double physics_distance(Physics_Collider* collider_1, Physics_Collider* collider_2, Vector* closest_1, Vector* closest_2);
+
+bool physics_collide(Physics_Collider* collider_1, Physics_Collider* collider_2, Physics_Collision* collision);
 
@@ -1,5 +1,11 @@
 #pragma once
 
+#ifndef _WIN32_WINNT
+
+#define _WIN32_WINNT 0x0600
+
+#endif
+
 #define byte win32_byte
 
 #define Polygon win32_Polygon
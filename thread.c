@@ -0,0 +1,326 @@
+#include "thread.h"
+
+#ifdef _WIN32
+
+#include "platform.h"
+
+static INIT_ONCE s_initialize_once = INIT_ONCE_STATIC_INIT;
+
+static CRITICAL_SECTION s_mutex;
+
+static CONDITION_VARIABLE s_work_condition;
+
+static CONDITION_VARIABLE s_done_condition;
+
+#else
+
+#include <pthread.h>
+
+#include <unistd.h>
+
+static pthread_once_t s_initialize_once = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t s_work_condition = PTHREAD_COND_INITIALIZER;
+
+static pthread_cond_t s_done_condition = PTHREAD_COND_INITIALIZER;
+
+#endif
+
+static Thread_Job* s_first_job;
+
+static Thread_Job* s_last_job;
+
+static void thread_lock()
+{
+#ifdef _WIN32
+	EnterCriticalSection(&s_mutex);
+#else
+	pthread_mutex_lock(&s_mutex);
+#endif
+}
+
+static void thread_unlock()
+{
+#ifdef _WIN32
+	LeaveCriticalSection(&s_mutex);
+#else
+	pthread_mutex_unlock(&s_mutex);
+#endif
+}
+
+static void thread_wait_for_work()
+{
+#ifdef _WIN32
+	SleepConditionVariableCS(&s_work_condition, &s_mutex, INFINITE);
+#else
+	pthread_cond_wait(&s_work_condition, &s_mutex);
+#endif
+}
+
+static void thread_wait_for_done()
+{
+#ifdef _WIN32
+	SleepConditionVariableCS(&s_done_condition, &s_mutex, INFINITE);
+#else
+	pthread_cond_wait(&s_done_condition, &s_mutex);
+#endif
+}
+
+static void thread_signal_work()
+{
+#ifdef _WIN32
+	WakeAllConditionVariable(&s_work_condition);
+#else
+	pthread_cond_broadcast(&s_work_condition);
+#endif
+}
+
+static void thread_signal_done()
+{
+#ifdef _WIN32
+	WakeAllConditionVariable(&s_done_condition);
+#else
+	pthread_cond_broadcast(&s_done_condition);
+#endif
+}
+
+static int thread_job_claim(Thread_Job* job)
+{
+	int index = job->next_index++;
+
+	if (job->next_index == job->task_count)
+	{
+		if (job->prev == NULL)
+		{
+			s_first_job = job->next;
+		}
+		else
+		{
+			job->prev->next = job->next;
+		}
+
+		if (job->next == NULL)
+		{
+			s_last_job = job->prev;
+		}
+		else
+		{
+			job->next->prev = job->prev;
+		}
+	}
+
+	return index;
+}
+
+static void thread_job_run(Thread_Job* job, int index)
+{
+	thread_unlock();
+
+	job->task(job->data, index);
+
+	thread_lock();
+
+	job->done_count++;
+
+	if (job->done_count == job->task_count)
+	{
+		thread_signal_done();
+	}
+}
+
+static void thread_work()
+{
+	thread_lock();
+
+	while (true)
+	{
+		if (s_first_job == NULL)
+		{
+			thread_wait_for_work();
+
+			continue;
+		}
+
+		Thread_Job* job = s_first_job;
+
+		thread_job_run(job, thread_job_claim(job));
+	}
+}
+
+#ifdef _WIN32
+
+static DWORD WINAPI thread_main(LPVOID parameter)
+{
+	thread_work();
+
+	return 0;
+}
+
+#else
+
+static void* thread_main(void* parameter)
+{
+	thread_work();
+
+	return NULL;
+}
+
+#endif
+
+static void thread_start()
+{
+	int thread_count = thread_get_processor_count() - 1;
+
+	if (thread_count < 1)
+	{
+		thread_count = 1;
+	}
+
+#ifdef _WIN32
+	InitializeCriticalSection(&s_mutex);
+
+	InitializeConditionVariable(&s_work_condition);
+
+	InitializeConditionVariable(&s_done_condition);
+
+	for (int i = 0; i < thread_count; i++)
+	{
+		CloseHandle(CreateThread(NULL, 0, thread_main, NULL, 0, NULL));
+	}
+#else
+	for (int i = 0; i < thread_count; i++)
+	{
+		pthread_t thread;
+
+		pthread_create(&thread, NULL, thread_main, NULL);
+
+		pthread_detach(thread);
+	}
+#endif
+}
+
+#ifdef _WIN32
+
+static BOOL CALLBACK thread_start_once(PINIT_ONCE once, PVOID parameter, PVOID* context)
+{
+	thread_start();
+
+	return TRUE;
+}
+
+#endif
+
+static void thread_initialize()
+{
+#ifdef _WIN32
+	InitOnceExecuteOnce(&s_initialize_once, thread_start_once, NULL, NULL);
+#else
+	pthread_once(&s_initialize_once, thread_start);
+#endif
+}
+
+int thread_get_processor_count()
+{
+#ifdef _WIN32
+	SYSTEM_INFO system_info;
+
+	GetSystemInfo(&system_info);
+
+	return system_info.dwNumberOfProcessors;
+#else
+	return sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+void thread_run_parallel(Thread_Task task, void* data, int task_count)
+{
+	if (task_count == 1)
+	{
+		task(data, 0);
+
+		return;
+	}
+
+	thread_job_wait(thread_job_submit(task, data, task_count));
+}
+
+Thread_Job* thread_job_submit(Thread_Task task, void* data, int task_count)
+{
+	Thread_Job* job = calloc(1, sizeof(Thread_Job));
+
+	job->task = task;
+
+	job->data = data;
+
+	job->task_count = task_count;
+
+	if (task_count == 0)
+	{
+		return job;
+	}
+
+	thread_initialize();
+
+	thread_lock();
+
+	if (s_last_job == NULL)
+	{
+		s_first_job = job;
+	}
+	else
+	{
+		s_last_job->next = job;
+
+		job->prev = s_last_job;
+	}
+
+	s_last_job = job;
+
+	thread_signal_work();
+
+	thread_unlock();
+
+	return job;
+}
+
+bool thread_job_is_done(const Thread_Job* job)
+{
+	if (job->task_count == 0)
+	{
+		return true;
+	}
+
+	thread_lock();
+
+	bool done = job->done_count == job->task_count;
+
+	thread_unlock();
+
+	return done;
+}
+
+void thread_job_wait(Thread_Job* job)
+{
+	if (job->task_count != 0)
+	{
+		thread_lock();
+
+		while (job->done_count < job->task_count)
+		{
+			if (job->next_index < job->task_count)
+			{
+				thread_job_run(job, thread_job_claim(job));
+			}
+			else
+			{
+				thread_wait_for_done();
+			}
+		}
+
+		thread_unlock();
+	}
+
+	free(job);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include <stdlib.h>
+
+typedef struct Thread_Job Thread_Job;
+
+typedef void (* Thread_Task)(void* data, int index);
+
+struct Thread_Job
+{
+	Thread_Task task;
+
+	void* data;
+
+	int task_count;
+
+	int next_index;
+
+	int done_count;
+
+	Thread_Job* prev;
+
+	Thread_Job* next;
+};
+
+int thread_get_processor_count();
+
+void thread_run_parallel(Thread_Task task, void* data, int task_count);
+
+Thread_Job* thread_job_submit(Thread_Task task, void* data, int task_count);
+
+bool thread_job_is_done(const Thread_Job* job);
+
+void thread_job_wait(Thread_Job* job);
@@ -0,0 +1,325 @@
+#include "tilemap.h"
+
+static void tilemap_set_vertex(Graphics_Vertex* vertex, double x, double y, double u, double v)
+{
+	vertex->x = x;
+
+	vertex->y = y;
+
+	vertex->u = u;
+
+	vertex->v = v;
+
+	vertex->color = 0xFFFFFFFF;
+}
+
+static void tilemap_build_chunk(Tilemap* tilemap, int chunk_x, int chunk_y)
+{
+	Tilemap_Chunk* chunk = &tilemap->chunks[chunk_y * tilemap->chunk_count_x + chunk_x];
+
+	int min_x = chunk_x * TILEMAP_CHUNK_SIZE;
+
+	int min_y = chunk_y * TILEMAP_CHUNK_SIZE;
+
+	int max_x = imin(min_x + TILEMAP_CHUNK_SIZE, tilemap->width);
+
+	int max_y = imin(min_y + TILEMAP_CHUNK_SIZE, tilemap->height);
+
+	double tile_u = 1.0 / tilemap->sheet_column_count;
+
+	double tile_v = 1.0 / tilemap->sheet_row_count;
+
+	chunk->vertex_count = 0;
+
+	for (int y = min_y; y < max_y; y++)
+	{
+		for (int x = min_x; x < max_x; x++)
+		{
+			int tile = tilemap->tiles[y * tilemap->width + x];
+
+			if (tile == TILEMAP_TILE_EMPTY)
+			{
+				continue;
+			}
+
+			Rect rect = tilemap_get_tile_rect(tilemap, x, y);
+
+			double u = tile % tilemap->sheet_column_count * tile_u;
+
+			double v = 1.0 - (tile / tilemap->sheet_column_count + 1) * tile_v;
+
+			Graphics_Vertex* vertices = &chunk->vertices[chunk->vertex_count];
+
+			tilemap_set_vertex(&vertices[0], rect.min.x, rect.min.y, u, v);
+
+			tilemap_set_vertex(&vertices[1], rect.max.x, rect.min.y, u + tile_u, v);
+
+			tilemap_set_vertex(&vertices[2], rect.max.x, rect.max.y, u + tile_u, v + tile_v);
+
+			vertices[3] = vertices[0];
+
+			vertices[4] = vertices[2];
+
+			tilemap_set_vertex(&vertices[5], rect.min.x, rect.max.y, u, v + tile_v);
+
+			chunk->vertex_count += 6;
+		}
+	}
+
+	chunk->is_dirty = false;
+}
+
+Tilemap* tilemap_create(const Texture* texture, int sheet_column_count, int sheet_row_count, int width, int height, Vector position, double tile_size)
+{
+	Tilemap* tilemap = malloc(sizeof(Tilemap));
+
+	tilemap->texture = texture;
+
+	tilemap->sheet_column_count = sheet_column_count;
+
+	tilemap->sheet_row_count = sheet_row_count;
+
+	tilemap->solid_tiles = calloc(sheet_column_count * sheet_row_count, sizeof(bool));
+
+	tilemap->position = position;
+
+	tilemap->tile_size = tile_size;
+
+	tilemap->width = width;
+
+	tilemap->height = height;
+
+	tilemap->tiles = malloc(width * height * sizeof(int));
+
+	for (int i = 0; i < width * height; i++)
+	{
+		tilemap->tiles[i] = TILEMAP_TILE_EMPTY;
+	}
+
+	tilemap->chunk_count_x = (width + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+
+	tilemap->chunk_count_y = (height + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+
+	tilemap->chunks = malloc(tilemap->chunk_count_x * tilemap->chunk_count_y * sizeof(Tilemap_Chunk));
+
+	for (int i = 0; i < tilemap->chunk_count_x * tilemap->chunk_count_y; i++)
+	{
+		tilemap->chunks[i].vertices = malloc(TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE * 6 * sizeof(Graphics_Vertex));
+
+		tilemap->chunks[i].vertex_count = 0;
+
+		tilemap->chunks[i].is_dirty = false;
+	}
+
+	return tilemap;
+}
+
+void tilemap_destroy(Tilemap* tilemap)
+{
+	for (int i = 0; i < tilemap->chunk_count_x * tilemap->chunk_count_y; i++)
+	{
+		free(tilemap->chunks[i].vertices);
+	}
+
+	free(tilemap->chunks);
+
+	free(tilemap->tiles);
+
+	free(tilemap->solid_tiles);
+
+	free(tilemap);
+}
+
+int tilemap_get_tile(const Tilemap* tilemap, int x, int y)
+{
+	if (x < 0 || y < 0 || x >= tilemap->width || y >= tilemap->height)
+	{
+		return TILEMAP_TILE_EMPTY;
+	}
+
+	return tilemap->tiles[y * tilemap->width + x];
+}
+
+void tilemap_set_tile(Tilemap* tilemap, int x, int y, int tile)
+{
+	if (x < 0 || y < 0 || x >= tilemap->width || y >= tilemap->height || tilemap->tiles[y * tilemap->width + x] == tile)
+	{
+		return;
+	}
+
+	if (tile < TILEMAP_TILE_EMPTY || tile >= tilemap->sheet_column_count * tilemap->sheet_row_count)
+	{
+		return;
+	}
+
+	tilemap->tiles[y * tilemap->width + x] = tile;
+
+	tilemap->chunks[y / TILEMAP_CHUNK_SIZE * tilemap->chunk_count_x + x / TILEMAP_CHUNK_SIZE].is_dirty = true;
+}
+
+void tilemap_set_tile_solid(Tilemap* tilemap, int tile, bool solid)
+{
+	if (tile < 0 || tile >= tilemap->sheet_column_count * tilemap->sheet_row_count)
+	{
+		return;
+	}
+
+	tilemap->solid_tiles[tile] = solid;
+}
+
+bool tilemap_is_solid(const Tilemap* tilemap, int x, int y)
+{
+	int tile = tilemap_get_tile(tilemap, x, y);
+
+	return tile != TILEMAP_TILE_EMPTY && tilemap->solid_tiles[tile];
+}
+
+Rect tilemap_get_tile_rect(const Tilemap* tilemap, int x, int y)
+{
+	Vector min = vector_add(tilemap->position, vector_create(x * tilemap->tile_size, y * tilemap->tile_size));
+
+	return (Rect){ min, vector_add(min, vector_create(tilemap->tile_size, tilemap->tile_size)) };
+}
+
+void tilemap_draw(Tilemap* tilemap)
+{
+	Rect visible_rect = graphics_get_visible_rect();
+
+	double chunk_size = tilemap->tile_size * TILEMAP_CHUNK_SIZE;
+
+	int min_x = imax((int)floor((visible_rect.min.x - tilemap->position.x) / chunk_size), 0);
+
+	int min_y = imax((int)floor((visible_rect.min.y - tilemap->position.y) / chunk_size), 0);
+
+	int max_x = imin((int)floor((visible_rect.max.x - tilemap->position.x) / chunk_size), tilemap->chunk_count_x - 1);
+
+	int max_y = imin((int)floor((visible_rect.max.y - tilemap->position.y) / chunk_size), tilemap->chunk_count_y - 1);
+
+	const Texture* texture = graphics_get_texture();
+
+	graphics_set_texture(tilemap->texture);
+
+	for (int y = min_y; y <= max_y; y++)
+	{
+		for (int x = min_x; x <= max_x; x++)
+		{
+			Tilemap_Chunk* chunk = &tilemap->chunks[y * tilemap->chunk_count_x + x];
+
+			if (chunk->is_dirty)
+			{
+				tilemap_build_chunk(tilemap, x, y);
+			}
+
+			graphics_draw_mesh(chunk->vertex_count, chunk->vertices);
+		}
+	}
+
+	graphics_set_texture(texture);
+}
+
+int tilemap_get_solid_rects(const Tilemap* tilemap, Rect** rects)
+{
+	bool* is_merged = calloc(tilemap->width * tilemap->height, sizeof(bool));
+
+	int rect_count = 0;
+
+	int rect_capacity = 0;
+
+	*rects = NULL;
+
+	for (int y = 0; y < tilemap->height; y++)
+	{
+		for (int x = 0; x < tilemap->width; x++)
+		{
+			if (is_merged[y * tilemap->width + x] || !tilemap_is_solid(tilemap, x, y))
+			{
+				continue;
+			}
+
+			int max_x = x + 1;
+
+			while (max_x < tilemap->width && !is_merged[y * tilemap->width + max_x] && tilemap_is_solid(tilemap, max_x, y))
+			{
+				max_x++;
+			}
+
+			int max_y = y + 1;
+
+			for (; max_y < tilemap->height; max_y++)
+			{
+				int i = x;
+
+				while (i < max_x && !is_merged[max_y * tilemap->width + i] && tilemap_is_solid(tilemap, i, max_y))
+				{
+					i++;
+				}
+
+				if (i < max_x)
+				{
+					break;
+				}
+			}
+
+			for (int j = y; j < max_y; j++)
+			{
+				for (int i = x; i < max_x; i++)
+				{
+					is_merged[j * tilemap->width + i] = true;
+				}
+			}
+
+			if (rect_count == rect_capacity)
+			{
+				rect_capacity = imax(rect_capacity * 2, 16);
+
+				*rects = realloc(*rects, rect_capacity * sizeof(Rect));
+			}
+
+			(*rects)[rect_count++] = (Rect){ tilemap_get_tile_rect(tilemap, x, y).min, tilemap_get_tile_rect(tilemap, max_x - 1, max_y - 1).max };
+		}
+	}
+
+	free(is_merged);
+
+	return rect_count;
+}
+
+void tilemap_create_colliders(const Tilemap* tilemap, Physics_Body* body)
+{
+	Rect* rects;
+
+	int rect_count = tilemap_get_solid_rects(tilemap, &rects);
+
+	if (rect_count == 0)
+	{
+		return;
+	}
+
+	Shape** shapes = malloc(rect_count * sizeof(Shape*));
+
+	Physics_Collider_Definition* definitions = malloc(rect_count * sizeof(Physics_Collider_Definition));
+
+	for (int i = 0; i < rect_count; i++)
+	{
+		Vector min = rects[i].min;
+
+		Vector max = rects[i].max;
+
+		shapes[i] = shape_create_polygon(4, (Vector[]){ { min.x, min.y }, { max.x, min.y }, { max.x, max.y }, { min.x, max.y } });
+
+		definitions[i] = physics_collider_definition_create(body, shapes[i], 0.0);
+	}
+
+	physics_colliders_create(rect_count, definitions, NULL);
+
+	for (int i = 0; i < rect_count; i++)
+	{
+		shape_destroy(shapes[i]);
+	}
+
+	free(definitions);
+
+	free(shapes);
+
+	free(rects);
+}
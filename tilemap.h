@@ -0,0 +1,69 @@
+#pragma once
+
+#include "graphics.h"
+
+#include "physics.h"
+
+#define TILEMAP_CHUNK_SIZE 16
+
+#define TILEMAP_TILE_EMPTY -1
+
+typedef struct Tilemap Tilemap;
+
+typedef struct Tilemap_Chunk Tilemap_Chunk;
+
+struct Tilemap
+{
+	const Texture* texture;
+
+	int sheet_column_count;
+
+	int sheet_row_count;
+
+	bool* solid_tiles;
+
+	Vector position;
+
+	double tile_size;
+
+	int width;
+
+	int height;
+
+	int* tiles;
+
+	int chunk_count_x;
+
+	int chunk_count_y;
+
+	Tilemap_Chunk* chunks;
+};
+
+struct Tilemap_Chunk
+{
+	Graphics_Vertex* vertices;
+
+	int vertex_count;
+
+	bool is_dirty;
+};
+
+Tilemap* tilemap_create(const Texture* texture, int sheet_column_count, int sheet_row_count, int width, int height, Vector position, double tile_size);
+
+void tilemap_destroy(Tilemap* tilemap);
+
+int tilemap_get_tile(const Tilemap* tilemap, int x, int y);
+
+void tilemap_set_tile(Tilemap* tilemap, int x, int y, int tile);
+
+void tilemap_set_tile_solid(Tilemap* tilemap, int tile, bool solid);
+
+bool tilemap_is_solid(const Tilemap* tilemap, int x, int y);
+
+Rect tilemap_get_tile_rect(const Tilemap* tilemap, int x, int y);
+
+void tilemap_draw(Tilemap* tilemap);
+
+int tilemap_get_solid_rects(const Tilemap* tilemap, Rect** rects);
+
+void tilemap_create_colliders(const Tilemap* tilemap, Physics_Body* body);
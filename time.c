@@ -1,24 +1,77 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "time.h"
 
+#include "math.h"
+
+#include <stdlib.h>
+
+#include <string.h>
+
+#ifdef _WIN32
+
 #include "platform.h"
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+
+#endif
+
+#endif
+
+static double s_frame_start_time;
+
+static double s_frame_end_time;
+
+static double s_frame_deadline;
+
+static double s_sleep_margin = FRAME_SLEEP_MARGIN_MAX;
+
+static double s_frame_times[FRAME_HISTORY_SIZE];
+
+static int s_frame_count;
+
+static int time_compare(const void* time_1, const void* time_2)
+{
+	double t_1 = *(const double*)time_1;
+
+	double t_2 = *(const double*)time_2;
+
+	return (t_1 > t_2) - (t_1 < t_2);
+}
+
+#ifdef _WIN32
+
 double get_time()
 {
+	static double period;
+
+	if (period == 0.0)
+	{
+		LARGE_INTEGER frequency;
+
+		QueryPerformanceFrequency(&frequency);
+
+		period = 1.0 / (double)frequency.QuadPart;
+	}
+
 	LARGE_INTEGER performance_count;
 	
 	QueryPerformanceCounter(&performance_count);
 
-	LARGE_INTEGER frequency;
-	
-	QueryPerformanceFrequency(&frequency);
-
-	return (double)performance_count.QuadPart / (double)frequency.QuadPart;
+	return (double)performance_count.QuadPart * period;
 }
 
 void sleep(double duration)
 {
 	static HANDLE timer;
 
+	if (timer == NULL)
+	{
+		timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	}
+
 	if (timer == NULL)
 	{
 		timer = CreateWaitableTimer(NULL, TRUE, NULL);
@@ -37,3 +90,143 @@ void sleep(double duration)
 
 	WaitForSingleObject(timer, INFINITE);
 }
+
+void sleep_until(double time)
+{
+	sleep(time - get_time());
+}
+
+#else
+
+#include <errno.h>
+
+#include <time.h>
+
+double get_time()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+void sleep(double duration)
+{
+	if (duration <= 0.0)
+	{
+		return;
+	}
+
+	struct timespec time;
+
+	time.tv_sec = duration;
+
+	time.tv_nsec = (duration - time.tv_sec) * 1e9;
+
+	nanosleep(&time, NULL);
+}
+
+void sleep_until(double time)
+{
+	struct timespec deadline;
+
+	deadline.tv_sec = time;
+
+	deadline.tv_nsec = (time - deadline.tv_sec) * 1e9;
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+	{
+	}
+}
+
+#endif
+
+void frame_begin()
+{
+	s_frame_start_time = get_time();
+}
+
+void frame_end(double target_hz)
+{
+	double time = get_time();
+
+	if (target_hz > 0.0)
+	{
+		double period = 1.0 / target_hz;
+
+		s_frame_deadline = fmax(s_frame_deadline + period, s_frame_start_time + period);
+
+		if (s_frame_deadline < time)
+		{
+			s_frame_deadline = time;
+		}
+
+		double sleep_time = s_frame_deadline - s_sleep_margin;
+
+		if (sleep_time > time)
+		{
+			sleep_until(sleep_time);
+
+			time = get_time();
+
+			s_sleep_margin = clamp(fmax(time - sleep_time + FRAME_SLEEP_MARGIN_MIN, s_sleep_margin * 0.99), FRAME_SLEEP_MARGIN_MIN, FRAME_SLEEP_MARGIN_MAX);
+		}
+
+		while (time < s_frame_deadline)
+		{
+			time = get_time();
+		}
+	}
+
+	if (s_frame_end_time > 0.0)
+	{
+		s_frame_times[s_frame_count % FRAME_HISTORY_SIZE] = time - s_frame_end_time;
+
+		s_frame_count++;
+	}
+
+	s_frame_end_time = time;
+}
+
+Frame_Statistics frame_get_statistics()
+{
+	Frame_Statistics statistics = { 0 };
+
+	int count = s_frame_count < FRAME_HISTORY_SIZE ? s_frame_count : FRAME_HISTORY_SIZE;
+
+	if (count == 0)
+	{
+		return statistics;
+	}
+
+	double times[FRAME_HISTORY_SIZE];
+
+	memcpy(times, s_frame_times, count * sizeof(double));
+
+	qsort(times, count, sizeof(double), time_compare);
+
+	statistics.frame_count = s_frame_count;
+
+	statistics.last = s_frame_times[(s_frame_count - 1) % FRAME_HISTORY_SIZE];
+
+	for (int i = 0; i < count; i++)
+	{
+		statistics.mean += times[i] / count;
+	}
+
+	statistics.p50 = times[(count - 1) / 2];
+
+	statistics.p99 = times[(int)ceil(count * 0.99) - 1];
+
+	statistics.max = times[count - 1];
+
+	return statistics;
+}
+
+void frame_reset_statistics()
+{
+	s_frame_count = 0;
+
+	s_frame_end_time = 0.0;
+}
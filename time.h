@@ -1,5 +1,46 @@
 #pragma once
 
+#ifndef _WIN32
+
+#include <unistd.h>
+
+#define sleep time_sleep // POSIX already has unsigned sleep(unsigned) in unistd.h
+
+#endif
+
+#define FRAME_HISTORY_SIZE 256
+
+#define FRAME_SLEEP_MARGIN_MIN 0.0002
+
+#define FRAME_SLEEP_MARGIN_MAX 0.004
+
+typedef struct Frame_Statistics Frame_Statistics;
+
+struct Frame_Statistics
+{
+	int frame_count;
+
+	double last;
+
+	double mean;
+
+	double p50;
+
+	double p99;
+
+	double max;
+};
+
 double get_time();
 
 void sleep(double duration);
+
+void sleep_until(double time);
+
+void frame_begin();
+
+void frame_end(double target_hz);
+
+Frame_Statistics frame_get_statistics();
+
+void frame_reset_statistics();
@@ -1,5 +1,147 @@
 #include "util.h"
 
+#include "thread.h"
+
+#include "time.h"
+
+typedef struct Stress_Step Stress_Step;
+
+struct Stress_Step
+{
+	Physics_World** worlds;
+
+	int world_count;
+
+	int task_count;
+};
+
+static Vector* s_debug_vertices;
+
+static int s_debug_vertex_count;
+
+static int s_debug_vertex_capacity;
+
+static Vector s_debug_circle[DEBUG_CIRCLE_VERTEX_COUNT];
+
+static bool s_debug_circle_is_ready;
+
+static void add_debug_segment(Vector a, Vector b)
+{
+	if (s_debug_vertex_count + 2 > s_debug_vertex_capacity)
+	{
+		s_debug_vertex_capacity = imax(s_debug_vertex_capacity * 2, 1024);
+
+		s_debug_vertices = realloc(s_debug_vertices, s_debug_vertex_capacity * sizeof(Vector));
+	}
+
+	s_debug_vertices[s_debug_vertex_count++] = a;
+
+	s_debug_vertices[s_debug_vertex_count++] = b;
+}
+
+static void add_debug_collider(Physics_Collider* collider)
+{
+	const Shape* world_shape = physics_collider_get_world_shape(collider);
+
+	switch (world_shape->type)
+	{
+		case SHAPE_TYPE_SEGMENT:
+		{
+			add_debug_segment(world_shape->segment.a, world_shape->segment.b);
+
+			break;
+		}
+		case SHAPE_TYPE_CIRCLE:
+		{
+			const Circle* circle = &world_shape->circle;
+
+			if (!s_debug_circle_is_ready)
+			{
+				for (int i = 0; i < DEBUG_CIRCLE_VERTEX_COUNT; i++)
+				{
+					s_debug_circle[i] = vector_create(cos(M_PI * 2.0 * i / DEBUG_CIRCLE_VERTEX_COUNT), sin(M_PI * 2.0 * i / DEBUG_CIRCLE_VERTEX_COUNT));
+				}
+
+				s_debug_circle_is_ready = true;
+			}
+
+			for (int i = DEBUG_CIRCLE_VERTEX_COUNT - 1, j = 0; j < DEBUG_CIRCLE_VERTEX_COUNT; i = j, j++)
+			{
+				add_debug_segment(vector_add(circle->center, vector_multiply(s_debug_circle[i], circle->radius)), vector_add(circle->center, vector_multiply(s_debug_circle[j], circle->radius)));
+			}
+
+			double angle = collider->body->angle;
+
+			add_debug_segment(circle->center, vector_add(circle->center, vector_create(circle->radius * cos(angle), circle->radius * sin(angle))));
+
+			break;
+		}
+		case SHAPE_TYPE_POLYGON:
+		{
+			const Polygon* polygon = &world_shape->polygon;
+
+			for (int i = polygon->point_count - 1, j = 0; j < polygon->point_count; i = j, j++)
+			{
+				add_debug_segment(polygon->points[i], polygon->points[j]);
+			}
+
+			break;
+		}
+	}
+}
+
+static void add_debug_rect(const Rect* rect)
+{
+	add_debug_segment(vector_create(rect->min.x, rect->min.y), vector_create(rect->max.x, rect->min.y));
+
+	add_debug_segment(vector_create(rect->max.x, rect->min.y), vector_create(rect->max.x, rect->max.y));
+
+	add_debug_segment(vector_create(rect->max.x, rect->max.y), vector_create(rect->min.x, rect->max.y));
+
+	add_debug_segment(vector_create(rect->min.x, rect->max.y), vector_create(rect->min.x, rect->min.y));
+}
+
+static void stress_step_task(void* data, int index)
+{
+	Stress_Step* step = data;
+
+	int end = step->world_count * (index + 1) / step->task_count;
+
+	for (int i = step->world_count * index / step->task_count; i < end; i++)
+	{
+		physics_world_step(step->worlds[i], 1.0 / 60.0);
+	}
+}
+
+static Physics_World* create_stress_world(int seed)
+{
+	Physics_World* world = physics_world_create();
+
+	world->gravity = vector_create(0, -10);
+
+	Physics_Body* ground = physics_body_create(world, PHYSICS_BODY_TYPE_STATIC);
+
+	physics_collider_create(ground, move_shape(create_rect_shape(vector_create(-50, -1), vector_create(50, 0))), 1.0);
+
+	for (int i = 0; i < STRESS_WORLD_BODY_COUNT; i++)
+	{
+		Physics_Body* body = physics_body_create(world, PHYSICS_BODY_TYPE_DYNAMIC);
+
+		body->position = vector_create(i % 10 * 2.1 - 10 + seed * 0.01, 1 + i / 10 * 2.1);
+
+		physics_collider_create(body, move_shape(shape_create_circle(vector_create(0, 0), 0.9)), 1.0);
+	}
+
+	return world;
+}
+
+static void draw_debug_segments()
+{
+	graphics_draw_lines(s_debug_vertex_count, s_debug_vertices);
+
+	s_debug_vertex_count = 0;
+}
+
 Shape* move_shape(Shape* shape)
 {
 	static Shape* old_shape;
@@ -35,42 +177,111 @@ void set_texture_and_color(const Texture* texture, const Color* color)
 
 void draw_physics_world(const Physics_World* world)
 {
-	set_texture_and_color(NULL, &(Color){ 0, 1, 0, 1 });
+	Rect visible_rect = graphics_get_visible_rect();
 
 	for (const List_Node* body_node = world->body_list.first; body_node != NULL; body_node = body_node->next)
 	{
 		const Physics_Body* body = body_node->item;
 
-		draw_physics_body(body);
+		for (const List_Node* collider_node = body->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+		{
+			Physics_Collider* collider = collider_node->item;
+
+			if (test_rect_rect(&collider->world_bounding_rect, &visible_rect))
+			{
+				add_debug_collider(collider);
+			}
+		}
 	}
 
-	set_texture_and_color(NULL, &(Color){ 0, 0, 1, 1 });
+	set_texture_and_color(NULL, &(Color){ 0, 1, 0, 1 });
+
+	draw_debug_segments();
 
 	for (const List_Node* joint_node = world->joint_list.first; joint_node != NULL; joint_node = joint_node->next)
 	{
 		const Physics_Joint* joint = joint_node->item;
 
-		draw_physics_joint(joint);
+		add_debug_segment(joint->world_anchor_1, joint->world_anchor_2);
+	}
+
+	set_texture_and_color(NULL, &(Color){ 0, 0, 1, 1 });
+
+	draw_debug_segments();
+}
+
+void draw_physics_world_bounding_rects(const Physics_World* world)
+{
+	Rect visible_rect = graphics_get_visible_rect();
+
+	for (const List_Node* body_node = world->body_list.first; body_node != NULL; body_node = body_node->next)
+	{
+		const Physics_Body* body = body_node->item;
+
+		for (const List_Node* collider_node = body->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
+		{
+			const Physics_Collider* collider = collider_node->item;
+
+			if (test_rect_rect(&collider->world_bounding_rect, &visible_rect))
+			{
+				add_debug_rect(&collider->world_bounding_rect);
+			}
+		}
+	}
+
+	set_texture_and_color(NULL, &(Color){ 1, 1, 0, 1 });
+
+	draw_debug_segments();
+}
+
+void draw_physics_world_collisions(const Physics_World* world)
+{
+	Rect camera = graphics_get_camera();
+
+	Rect visible_rect = graphics_get_visible_rect();
+
+	double size = fabs(camera.max.y - camera.min.y) * 0.01;
+
+	for (int i = 0; i < world->collision_count; i++)
+	{
+		const Collision* collision = &world->collisions[i].collision;
+
+		if (!test_point_rect(collision->point, &visible_rect))
+		{
+			continue;
+		}
+
+		add_debug_segment(vector_subtract(collision->point, vector_create(size, size)), vector_add(collision->point, vector_create(size, size)));
+
+		add_debug_segment(vector_subtract(collision->point, vector_create(size, -size)), vector_add(collision->point, vector_create(size, -size)));
+
+		add_debug_segment(collision->point, vector_add(collision->point, vector_multiply(collision->normal, fmax(collision->depth, size * 2.0))));
 	}
+
+	set_texture_and_color(NULL, &(Color){ 1, 0, 1, 1 });
+
+	draw_debug_segments();
 }
 
 void draw_physics_body(const Physics_Body* body)
 {
 	for (const List_Node* collider_node = body->collider_list.first; collider_node != NULL; collider_node = collider_node->next)
 	{
-		const Physics_Collider* collider = collider_node->item;
+		Physics_Collider* collider = collider_node->item;
 
 		draw_physics_collider(collider);
 	}
 }
 
-void draw_physics_collider(const Physics_Collider* collider)
+void draw_physics_collider(Physics_Collider* collider)
 {
-	graphics_draw_shape(collider->world_shape, false);
+	const Shape* world_shape = physics_collider_get_world_shape(collider);
 
-	if (collider->world_shape->type == SHAPE_TYPE_CIRCLE)
+	graphics_draw_shape(world_shape, false);
+
+	if (world_shape->type == SHAPE_TYPE_CIRCLE)
 	{
-		const Circle* circle = &collider->world_shape->circle;
+		const Circle* circle = &world_shape->circle;
 
 		double angle = collider->body->angle;
 
@@ -91,3 +302,49 @@ Vector get_mouse_position()
 
 	return mouse_position;
 }
+
+double measure_physics_worlds_step(int world_count, int step_count, int thread_count)
+{
+	Physics_World** worlds = malloc(world_count * sizeof(Physics_World*));
+
+	for (int i = 0; i < world_count; i++)
+	{
+		worlds[i] = create_stress_world(i);
+	}
+
+	Stress_Step step = { worlds, world_count, imax(imin(thread_count, world_count), 1) };
+
+	thread_run_parallel(stress_step_task, &step, step.task_count);
+
+	double start_time = get_time();
+
+	for (int i = 0; i < step_count; i++)
+	{
+		thread_run_parallel(stress_step_task, &step, step.task_count);
+	}
+
+	double duration = get_time() - start_time;
+
+	for (int i = 0; i < world_count; i++)
+	{
+		physics_world_destroy(worlds[i]);
+	}
+
+	free(worlds);
+
+	return duration;
+}
+
+void print_physics_worlds_scaling(int world_count, int step_count)
+{
+	double single_duration = measure_physics_worlds_step(world_count, step_count, 1);
+
+	printf("%d worlds, %d steps\n", world_count, step_count);
+
+	for (int thread_count = 1; thread_count <= thread_get_processor_count(); thread_count++)
+	{
+		double duration = thread_count == 1 ? single_duration : measure_physics_worlds_step(world_count, step_count, thread_count);
+
+		printf("%2d threads: %8.1f ms, speedup %.2f\n", thread_count, duration * 1000.0, single_duration / duration);
+	}
+}
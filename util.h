@@ -8,6 +8,10 @@
 
 #define countof(a) (sizeof(a) / sizeof((a)[0]))
 
+#define DEBUG_CIRCLE_VERTEX_COUNT 24
+
+#define STRESS_WORLD_BODY_COUNT 100
+
 Shape* move_shape(Shape* shape);
 
 Shape* create_rect_shape(Vector min, Vector max);
@@ -16,10 +20,18 @@ void set_texture_and_color(const Texture* texture, const Color* color);
 
 void draw_physics_world(const Physics_World* world);
 
+void draw_physics_world_bounding_rects(const Physics_World* world);
+
+void draw_physics_world_collisions(const Physics_World* world);
+
 void draw_physics_body(const Physics_Body* body);
 
-void draw_physics_collider(const Physics_Collider* collider);
+void draw_physics_collider(Physics_Collider* collider);
 
 void draw_physics_joint(const Physics_Joint* joint);
 
 Vector get_mouse_position();
+
+double measure_physics_worlds_step(int world_count, int step_count, int thread_count);
+
+void print_physics_worlds_scaling(int world_count, int step_count);
@@ -1,5 +1,7 @@
 #include "window.h"
 
+#include "graphics_gl.h"
+
 #include "platform.h"
 
 static WNDCLASS s_window_class;
@@ -30,6 +32,8 @@ static LRESULT CALLBACK window_proc(HWND window, UINT message, WPARAM wparam, LP
 		{
 			glViewport(0, 0, LOWORD(lparam), HIWORD(lparam));
 
+			graphics_set_viewport_size(LOWORD(lparam), HIWORD(lparam));
+
 			break;
 		}
 		case WM_CLOSE:
@@ -137,6 +141,8 @@ void window_create(int width, int height, const char* title)
 	glShadeModel(GL_FLAT);
 
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	graphics_set_backend(graphics_gl_get_backend());
 }
 
 void window_destroy()
@@ -174,6 +180,10 @@ void window_update()
 
 void window_display()
 {
+	graphics_upload_textures(GRAPHICS_TEXTURE_UPLOAD_TIME_BUDGET);
+
+	graphics_flush();
+
 	SwapBuffers(s_device_context);
 }
 
@@ -225,19 +235,9 @@ void window_get_mouse_position(double* x, double* y)
 
 	ScreenToClient(s_window, &mouse_pos);
 
-	double modelview_matrix[16];
-
-	double projection_matrix[16];
-
-	int viewport[4];
-
-	glGetDoublev(GL_MODELVIEW_MATRIX, modelview_matrix);
-
-	glGetDoublev(GL_PROJECTION_MATRIX, projection_matrix);
-
-	glGetIntegerv(GL_VIEWPORT, viewport);
+	Vector position = graphics_unproject(vector_create(mouse_pos.x, mouse_pos.y));
 
-	double z;
+	*x = position.x;
 
-	gluUnProject(mouse_pos.x, viewport[3] - mouse_pos.y, 0.0, modelview_matrix, projection_matrix, viewport, x, y, &z);
+	*y = position.y;
 }